@@ -17,3 +17,8 @@ int fov_3d_z_range;
 bool tile_iso;
 bool pixel_minimap_option = false;
 int PICKUP_RANGE;
+bool profile_startup = false;
+int overmap_prepare_distance = 0;
+int worker_threads = 1;
+bool parallel_monster_planning = false;
+bool fast_forward = false;
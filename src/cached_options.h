@@ -87,4 +87,34 @@ extern int PICKUP_RANGE;
  */
 extern bool dont_debugmsg;
 
+/**
+ * If true, the time taken by each step of data loading, finalization and
+ * verification is shown in the loading screen and written to the debug log.
+ */
+extern bool profile_startup;
+
+/**
+ * Distance in overmap tiles from an overmap edge at which the overmap across it
+ * is loaded or generated ahead of time, 0 disables it.
+ */
+extern int overmap_prepare_distance;
+
+/**
+ * Number of threads thread_pool runs tasks on, 1 forces single-threaded operation.
+ * 0 means one per hardware thread.
+ */
+extern int worker_threads;
+
+/**
+ * If true, monsters check which creatures they see on the worker threads before
+ * their turns, instead of each one when it plans its move.
+ */
+extern bool parallel_monster_planning;
+
+/**
+ * If true, turns the player spends asleep or busy with an activity while no hostile
+ * is around are simulated with less detail for the player, see game::can_fast_forward.
+ */
+extern bool fast_forward;
+
 #endif // CATA_SRC_CACHED_OPTIONS_H
@@ -535,10 +535,18 @@ bool read_from_file( const std::string &path, const std::function<void( std::ist
     }
 }
 
+// Parsing from memory is a lot faster than parsing from the file stream,
+// so the whole file is read up front.
+static std::string read_whole_stream( std::istream &fin )
+{
+    return std::string( std::istreambuf_iterator<char>( fin ), std::istreambuf_iterator<char>() );
+}
+
 bool read_from_file_json( const std::string &path, const std::function<void( JsonIn & )> &reader )
 {
     return read_from_file( path, [&]( std::istream & fin ) {
-        JsonIn jsin( fin, path );
+        const std::string data = read_whole_stream( fin );
+        JsonIn jsin( data.data(), data.size(), path );
         reader( jsin );
     } );
 }
@@ -563,7 +571,8 @@ bool read_from_file_optional_json( const std::string &path,
                                    const std::function<void( JsonIn & )> &reader )
 {
     return read_from_file_optional( path, [&]( std::istream & fin ) {
-        JsonIn jsin( fin, path );
+        const std::string data = read_whole_stream( fin );
+        JsonIn jsin( data.data(), data.size(), path );
         reader( jsin );
     } );
 }
@@ -666,7 +675,6 @@ std::string serialize_wrapper( const std::function<void( JsonOut & )> &callback
 
 void deserialize_wrapper( const std::function<void( JsonIn & )> &callback, const std::string &data )
 {
-    std::istringstream buffer( data );
-    JsonIn jsin( buffer );
+    JsonIn jsin( data.data(), data.size() );
     callback( jsin );
 }
@@ -4672,6 +4672,12 @@ void Character::update_body( const time_point &from, const time_point &to )
     if( !is_npc() ) {
         update_stamina( to_turns<int>( to - from ) );
     }
+    update_body_by_minute( from, to );
+    do_skill_rust();
+}
+
+void Character::update_body_by_minute( const time_point &from, const time_point &to )
+{
     update_stomach( from, to );
     recalculate_enchantment_cache();
     if( ticks_between( from, to, 3_minutes ) > 0 ) {
@@ -4712,8 +4718,6 @@ void Character::update_body( const time_point &from, const time_point &to )
             }
         }
     }
-
-    do_skill_rust();
 }
 
 item *Character::best_quality_item( const quality_id &qual )
@@ -10226,7 +10230,8 @@ bool Character::is_visible_in_range( const Creature &critter, const int range )
 
 std::vector<Creature *> Character::get_visible_creatures( const int range ) const
 {
-    return g->get_creatures_if( [this, range]( const Creature & critter ) -> bool {
+    return g->get_creatures_in_range_if( pos(), range,
+    [this, range]( const Creature & critter ) -> bool {
         return this != &critter && pos() != critter.pos() && // TODO: get rid of fake npcs (pos() check)
         rl_dist( pos(), critter.pos() ) <= range && sees( critter );
     } );
@@ -10234,7 +10239,8 @@ std::vector<Creature *> Character::get_visible_creatures( const int range ) cons
 
 std::vector<Creature *> Character::get_hostile_creatures( int range ) const
 {
-    return g->get_creatures_if( [this, range]( const Creature & critter ) -> bool {
+    return g->get_creatures_in_range_if( pos(), range,
+    [this, range]( const Creature & critter ) -> bool {
         // Fixes circular distance range for ranged attacks
         float dist_to_creature = std::round( rl_dist_exact( pos(), critter.pos() ) );
         return this != &critter && pos() != critter.pos() && // TODO: get rid of fake npcs (pos() check)
@@ -432,6 +432,13 @@ class Character : public Creature, public visitable<Character>
         void update_body();
         /** Updates all "biology" as if time between `from` and `to` passed. */
         void update_body( const time_point &from, const time_point &to );
+        /**
+         * The part of @ref update_body that counts the intervals passed between `from` and `to`,
+         * so it can be applied once for many turns. Leaves out stamina and skill rust, which
+         * depend on the exact turn.
+         */
+        void update_body_by_minute( const time_point &from, const time_point &to );
+        void do_skill_rust();
         /** Updates the stomach to give accurate hunger messages */
         void update_stomach( const time_point &from, const time_point &to );
         /** Increases hunger, thirst, fatigue and stimulants wearing off. `rate_multiplier` is for retroactive updates. */
@@ -818,7 +825,6 @@ class Character : public Creature, public visitable<Character>
         /** Applies skill-based boosts to stats **/
         void apply_skill_boost();
     protected:
-        void do_skill_rust();
         /** Applies stat mods to character. */
         void apply_mods( const trait_id &mut, bool add_remove );
 
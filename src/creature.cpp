@@ -368,7 +368,8 @@ Creature *Creature::auto_find_hostile_target( int range, int &boo_hoo, int area
         self_area_iff = true;
     }
 
-    std::vector<Creature *> targets = g->get_creatures_if( [&]( const Creature & critter ) {
+    std::vector<Creature *> targets = g->get_creatures_in_range_if( pos(), range,
+    [&]( const Creature & critter ) {
         if( critter.is_monster() ) {
             // friendly to the player, not a target for us
             return static_cast<const monster *>( &critter )->friendly == 0;
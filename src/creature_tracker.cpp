@@ -6,7 +6,9 @@
 #include <string>
 #include <utility>
 
+#include "coordinate_conversions.h"
 #include "debug.h"
+#include "line.h"
 #include "mongroup.h"
 #include "monster.h"
 #include "mtype.h"
@@ -86,7 +88,7 @@ bool Creature_tracker::add( shared_ptr_fast<monster> critter_ptr )
     }
 
     monsters_list.emplace_back( critter_ptr );
-    monsters_by_location[critter.pos()] = critter_ptr;
+    set_location( critter.pos(), critter_ptr );
     add_to_faction_map( critter_ptr );
     return true;
 }
@@ -136,8 +138,11 @@ bool Creature_tracker::update_pos( const monster &critter, const tripoint &new_p
         return ptr.get() == &critter;
     } );
     if( iter != monsters_list.end() ) {
-        monsters_by_location.erase( critter.pos() );
-        monsters_by_location[new_pos] = *iter;
+        const auto old_iter = monsters_by_location.find( critter.pos() );
+        if( old_iter != monsters_by_location.end() ) {
+            erase_location( old_iter );
+        }
+        set_location( new_pos, *iter );
         return true;
     } else {
         const tripoint &old_pos = critter.pos();
@@ -156,7 +161,7 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
 {
     const auto pos_iter = monsters_by_location.find( critter.pos() );
     if( pos_iter != monsters_by_location.end() && pos_iter->second.get() == &critter ) {
-        monsters_by_location.erase( pos_iter );
+        erase_location( pos_iter );
         return;
     }
 
@@ -167,8 +172,104 @@ void Creature_tracker::remove_from_location_map( const monster &critter )
         return v.second.get() == &critter;
     } );
     if( iter != monsters_by_location.end() ) {
-        monsters_by_location.erase( iter );
+        erase_location( iter );
+    }
+}
+
+void Creature_tracker::set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter )
+{
+    const auto iter = monsters_by_location.find( pos );
+    if( iter != monsters_by_location.end() ) {
+        erase_location( iter );
+    }
+    monsters_by_location.emplace( pos, critter );
+
+    const tripoint sm = ms_to_sm_copy( pos );
+    if( monsters_by_submap.empty() ) {
+        submaps_min = sm;
+        submaps_max = sm;
+    } else {
+        submaps_min = tripoint( std::min( submaps_min.x, sm.x ), std::min( submaps_min.y, sm.y ),
+                                std::min( submaps_min.z, sm.z ) );
+        submaps_max = tripoint( std::max( submaps_max.x, sm.x ), std::max( submaps_max.y, sm.y ),
+                                std::max( submaps_max.z, sm.z ) );
+    }
+    monsters_by_submap[sm].push_back( critter );
+}
+
+void Creature_tracker::erase_location( const
+                                       std::unordered_map<tripoint, shared_ptr_fast<monster>>::iterator iter )
+{
+    const auto bucket = monsters_by_submap.find( ms_to_sm_copy( iter->first ) );
+    if( bucket != monsters_by_submap.end() ) {
+        std::vector<shared_ptr_fast<monster>> &mons = bucket->second;
+        const auto mon_iter = std::find( mons.begin(), mons.end(), iter->second );
+        if( mon_iter != mons.end() ) {
+            mons.erase( mon_iter );
+        }
     }
+    monsters_by_location.erase( iter );
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_cuboid( const tripoint &min,
+                                   const tripoint &max ) const
+{
+    std::vector<shared_ptr_fast<monster>> result;
+    if( monsters_by_submap.empty() ) {
+        return result;
+    }
+    const tripoint sm_min = ms_to_sm_copy( min );
+    const tripoint sm_max = ms_to_sm_copy( max );
+    for( int z = std::max( sm_min.z, submaps_min.z ); z <= std::min( sm_max.z, submaps_max.z ); ++z ) {
+        for( int x = std::max( sm_min.x, submaps_min.x ); x <= std::min( sm_max.x, submaps_max.x ); ++x ) {
+            for( int y = std::max( sm_min.y, submaps_min.y ); y <= std::min( sm_max.y, submaps_max.y ); ++y ) {
+                const auto bucket = monsters_by_submap.find( tripoint( x, y, z ) );
+                if( bucket == monsters_by_submap.end() ) {
+                    continue;
+                }
+                for( const shared_ptr_fast<monster> &mon_ptr : bucket->second ) {
+                    const tripoint &pos = mon_ptr->pos();
+                    if( !mon_ptr->is_dead() &&
+                        pos.x >= min.x && pos.y >= min.y && pos.z >= min.z &&
+                        pos.x <= max.x && pos.y <= max.y && pos.z <= max.z ) {
+                        result.push_back( mon_ptr );
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_radius( const tripoint &center,
+                                   const int radius ) const
+{
+    std::vector<shared_ptr_fast<monster>> result = find_in_cuboid(
+                center - tripoint( radius, radius, 0 ), center + tripoint( radius, radius, 0 ) );
+    result.erase( std::remove_if( result.begin(), result.end(),
+    [&]( const shared_ptr_fast<monster> &mon_ptr ) {
+        return rl_dist( center, mon_ptr->pos() ) > radius;
+    } ), result.end() );
+    return result;
+}
+
+std::vector<shared_ptr_fast<monster>> Creature_tracker::find_in_cone( const tripoint &origin,
+                                   const units::angle direction, const units::angle spread, const int range ) const
+{
+    std::vector<shared_ptr_fast<monster>> result = find_in_radius( origin, range );
+    result.erase( std::remove_if( result.begin(), result.end(),
+    [&]( const shared_ptr_fast<monster> &mon_ptr ) {
+        if( mon_ptr->pos() == origin ) {
+            return true;
+        }
+        units::angle off = units::fmod( units::fabs( coord_to_angle( origin, mon_ptr->pos() ) - direction ),
+                                        360_degrees );
+        if( off > 180_degrees ) {
+            off = 360_degrees - off;
+        }
+        return off * 2 > spread;
+    } ), result.end() );
+    return result;
 }
 
 void Creature_tracker::remove( const monster &critter )
@@ -200,6 +301,7 @@ void Creature_tracker::clear()
 {
     monsters_list.clear();
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     removed_.clear();
 }
@@ -207,9 +309,10 @@ void Creature_tracker::clear()
 void Creature_tracker::rebuild_cache()
 {
     monsters_by_location.clear();
+    monsters_by_submap.clear();
     monster_faction_map_.clear();
     for( const shared_ptr_fast<monster> &mon_ptr : monsters_list ) {
-        monsters_by_location[mon_ptr->pos()] = mon_ptr;
+        set_location( mon_ptr->pos(), mon_ptr );
         add_to_faction_map( mon_ptr );
     }
 }
@@ -228,13 +331,13 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
     shared_ptr_fast<monster> first_ptr;
     if( first_iter != monsters_by_location.end() ) {
         first_ptr = first_iter->second;
-        monsters_by_location.erase( first_iter );
+        erase_location( first_iter );
     }
 
     shared_ptr_fast<monster> second_ptr;
     if( second_iter != monsters_by_location.end() ) {
         second_ptr = second_iter->second;
-        monsters_by_location.erase( second_iter );
+        erase_location( second_iter );
     }
     // implied: (first_ptr != second_ptr) or (first_ptr == nullptr && second_ptr == nullptr)
 
@@ -244,10 +347,10 @@ void Creature_tracker::swap_positions( monster &first, monster &second )
 
     // If the pointers have been taken out of the list, put them back in.
     if( first_ptr ) {
-        monsters_by_location[first.pos()] = first_ptr;
+        set_location( first.pos(), first_ptr );
     }
     if( second_ptr ) {
-        monsters_by_location[second.pos()] = second_ptr;
+        set_location( second.pos(), second_ptr );
     }
 }
 
@@ -11,6 +11,7 @@
 #include "memory_fast.h"
 #include "point.h"
 #include "type_id.h"
+#include "units_angle.h"
 
 class JsonIn;
 class JsonOut;
@@ -84,6 +85,27 @@ class Creature_tracker
             return monsters_list;
         }
 
+        /**
+         * Returns the living monsters whose position lies within the cuboid spanned by
+         * @p min and @p max, bounds included. This only looks at the monsters of the submaps
+         * the cuboid overlaps, so it's much cheaper than going through all monsters when
+         * the cuboid is small compared to the reality bubble.
+         */
+        std::vector<shared_ptr_fast<monster>> find_in_cuboid( const tripoint &min,
+                                           const tripoint &max ) const;
+        /**
+         * Returns the living monsters on the z-level of @p center that are at most
+         * @p radius away from it, as measured by @ref rl_dist.
+         */
+        std::vector<shared_ptr_fast<monster>> find_in_radius( const tripoint &center, int radius ) const;
+        /**
+         * Returns the living monsters found by @ref find_in_radius( @p origin, @p range ) whose
+         * bearing from @p origin (see @ref coord_to_angle) is at most half of @p spread away
+         * from @p direction. Monsters standing on @p origin have no bearing and are left out.
+         */
+        std::vector<shared_ptr_fast<monster>> find_in_cone( const tripoint &origin, units::angle direction,
+                                           units::angle spread, int range ) const;
+
         void serialize( JsonOut &jsout ) const;
         void deserialize( JsonIn &jsin );
 
@@ -94,8 +116,23 @@ class Creature_tracker
     private:
         std::vector<shared_ptr_fast<monster>> monsters_list;
         std::unordered_map<tripoint, shared_ptr_fast<monster>> monsters_by_location;
+        /**
+         * The monsters of @ref monsters_by_location, bucketed by the submap (x/y divided by
+         * SEEX/SEEY) of their key there. Empty buckets are kept around.
+         */
+        std::unordered_map<tripoint, std::vector<shared_ptr_fast<monster>>> monsters_by_submap;
+        /** Bounds of the keys of @ref monsters_by_submap */
+        tripoint submaps_min;
+        tripoint submaps_max;
         /** Remove the monsters entry in @ref monsters_by_location */
         void remove_from_location_map( const monster &critter );
+        /**
+         * Put @p critter into @ref monsters_by_location at @p pos, replacing whatever was
+         * there, and into @ref monsters_by_submap.
+         */
+        void set_location( const tripoint &pos, const shared_ptr_fast<monster> &critter );
+        /** Erase an entry of @ref monsters_by_location, and its copy in @ref monsters_by_submap */
+        void erase_location( std::unordered_map<tripoint, shared_ptr_fast<monster>>::iterator iter );
 };
 
 #endif // CATA_SRC_CREATURE_TRACKER_H
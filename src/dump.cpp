@@ -40,7 +40,7 @@ bool game::dump_stats( const std::string &what, dump_mode mode,
 {
     try {
         loading_ui ui( false );
-        load_core_data( ui );
+        load_core_data();
         load_packs( _( "Loading content packs" ), { mod_management::get_default_core_content_pack() }, ui );
         DynamicDataLoader::get_instance().finalize_loaded_data( ui );
     } catch( const std::exception &err ) {
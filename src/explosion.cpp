@@ -22,6 +22,7 @@
 #include "cata_utility.h"
 #include "color.h"
 #include "creature.h"
+#include "creature_tracker.h"
 #include "damage.h"
 #include "debug.h"
 #include "enums.h"
@@ -40,6 +41,7 @@
 #include "map_iterator.h"
 #include "mapdata.h"
 #include "material.h"
+#include "memory_fast.h"
 #include "math_defines.h"
 #include "messages.h"
 #include "mongroup.h"
@@ -929,7 +931,10 @@ void explosion_funcs::flashbang( const queued_explosion &qe )
                                  time_duration::from_turns( 10 - dist ) );
         }
     }
-    for( monster &critter : g->all_monsters() ) {
+    const std::vector<shared_ptr_fast<monster>> flashed = g->critter_tracker->find_in_cuboid(
+                p - tripoint( 8, 8, 8 ), p + tripoint( 8, 8, 8 ) );
+    for( const shared_ptr_fast<monster> &critter_ptr : flashed ) {
+        monster &critter = *critter_ptr;
         if( critter.type->in_species( ROBOT ) ) {
             continue;
         }
@@ -971,14 +976,13 @@ void explosion_funcs::shockwave( const queued_explosion &qe )
                    false,
                    "misc", "shockwave" );
 
-    for( monster &critter : g->all_monsters() ) {
-        if( critter.posz() != p.z ) {
+    // Knockback moves monsters around, so work on a snapshot of the ones in range
+    for( const shared_ptr_fast<monster> &critter : g->critter_tracker->find_in_radius( p, sw.radius ) ) {
+        if( critter->is_dead() ) {
             continue;
         }
-        if( rl_dist( critter.pos(), p ) <= sw.radius ) {
-            add_msg( _( "%s is caught in the shockwave!" ), critter.name() );
-            g->knockback( p, critter.pos(), sw.force, sw.stun, sw.dam_mult, qe.source );
-        }
+        add_msg( _( "%s is caught in the shockwave!" ), critter->name() );
+        g->knockback( p, critter->pos(), sw.force, sw.stun, sw.dam_mult, qe.source );
     }
     // TODO: combine the two loops and the case for g->u using all_creatures()
     for( npc &guy : g->all_npcs() ) {
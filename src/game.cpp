@@ -44,6 +44,7 @@
 #include "basecamp.h"
 #include "bionics.h"
 #include "bodypart.h"
+#include "cached_options.h"
 #include "cata_utility.h"
 #include "catacharset.h"
 #include "character.h"
@@ -133,6 +134,7 @@
 #include "overmapbuffer.h"
 #include "panels.h"
 #include "path_info.h"
+#include "pathfinding.h"
 #include "pickup.h"
 #include "player.h"
 #include "player_activity.h"
@@ -155,6 +157,7 @@
 #include "string_id.h"
 #include "string_input_popup.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "timed_event.h"
 #include "translations.h"
@@ -377,7 +380,7 @@ bool game::check_mod_data( const std::vector<mod_id> &opts, loading_ui &ui )
 
         // if no loadable mods then test core data only
         try {
-            load_core_data( ui );
+            load_core_data();
             DynamicDataLoader::get_instance().finalize_loaded_data( ui );
         } catch( const std::exception &err ) {
             std::cerr << "Error loading data from json: " << err.what() << std::endl;
@@ -417,15 +420,15 @@ bool game::check_mod_data( const std::vector<mod_id> &opts, loading_ui &ui )
         std::cout << "Checking mod " << mod.name() << " [" << mod.ident.str() << "]" << std::endl;
 
         try {
-            load_core_data( ui );
+            load_core_data();
 
             // Load any dependencies
             for( auto &dep : tree.get_dependencies_of_X_as_strings( mod.ident ) ) {
-                load_data_from_dir( dep->path, dep->ident.str(), ui );
+                load_data_from_dir( dep->path, dep->ident.str() );
             }
 
             // Load mod itself
-            load_data_from_dir( mod.path, mod.ident.str(), ui );
+            load_data_from_dir( mod.path, mod.ident.str() );
             DynamicDataLoader::get_instance().finalize_loaded_data( ui );
         } catch( const std::exception &err ) {
             std::cerr << "Error loading data: " << err.what() << std::endl;
@@ -445,18 +448,18 @@ bool game::is_core_data_loaded() const
     return DynamicDataLoader::get_instance().is_data_finalized();
 }
 
-void game::load_core_data( loading_ui &ui )
+void game::load_core_data()
 {
     // core data can be loaded only once and must be first
     // anyway.
     DynamicDataLoader::get_instance().unload_data();
 
-    load_data_from_dir( PATH_INFO::jsondir(), "core", ui );
+    load_data_from_dir( PATH_INFO::jsondir(), "core" );
 }
 
-void game::load_data_from_dir( const std::string &path, const std::string &src, loading_ui &ui )
+void game::load_data_from_dir( const std::string &path, const std::string &src )
 {
-    DynamicDataLoader::get_instance().load_data_from_path( path, src, ui );
+    DynamicDataLoader::get_instance().load_data_from_path( path, src );
 }
 
 #if !(defined(_WIN32) || defined(TILES))
@@ -586,7 +589,7 @@ void game::setup()
         ui_manager::redraw();
         refresh_display();
 
-        load_core_data( ui );
+        load_core_data();
     }
 
     load_world_modfiles( ui );
@@ -599,6 +602,10 @@ void game::setup()
 
     next_npc_id = character_id( 1 );
     next_mission_id = 1;
+    // NPCs of a different world may be waiting for their turn to search
+    get_npc_perception() = npc_perception();
+    fast_forwarding = false;
+    body_held_back_since = cata::nullopt;
     new_game = true;
     uquit = QUIT_NO;   // We haven't quit the game
     bVMonsterLookFire = true;
@@ -1502,7 +1509,7 @@ bool game::do_turn()
 
     debug_hour_timer.print_time();
 
-    u.update_body();
+    update_player_body();
 
     // Auto-save if autosave is enabled
     if( get_option<bool>( "AUTOSAVE" ) &&
@@ -1617,6 +1624,10 @@ bool game::do_turn()
     // consider a stripped down cache just for monsters.
     m.build_map_cache( get_levz(), true );
     monmove();
+    // Stop right away if a hostile came near
+    fast_forwarding = fast_forwarding && can_fast_forward();
+    // Get the neighbouring overmaps ready before the player walks into them.
+    overmap_buffer.prepare_neighbors( u.global_omt_location() );
     if( calendar::once_every( 5_minutes ) ) {
         overmap_npc_move();
     }
@@ -1635,7 +1646,7 @@ bool game::do_turn()
     explosion_handler::get_explosion_queue().execute();
     cleanup_dead();
 
-    if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) ) {
+    if( u.moves < 0 && get_option<bool>( "FORCE_REDRAW" ) && !fast_forwarding ) {
         ui_manager::redraw();
         refresh_display();
     }
@@ -1669,8 +1680,10 @@ bool game::do_turn()
         }
     }
     if( wait_redraw ) {
-        if( first_redraw_since_waiting_started ||
-            calendar::once_every( std::min( 1_minutes, wait_refresh_rate ) ) ) {
+        // When fast-forwarding, the popup is only shown again along with the rest of the screen
+        const time_duration popup_refresh_rate = fast_forwarding ? wait_refresh_rate :
+                std::min( 1_minutes, wait_refresh_rate );
+        if( first_redraw_since_waiting_started || calendar::once_every( popup_refresh_rate ) ) {
             if( first_redraw_since_waiting_started || calendar::once_every( wait_refresh_rate ) ) {
                 ui_manager::redraw();
             }
@@ -1767,6 +1780,61 @@ void game::process_voluntary_act_interrupt()
     }
 }
 
+bool game::can_fast_forward()
+{
+    if( !fast_forward || u.has_destination() || u.controlling_vehicle ) {
+        return false;
+    }
+    const bool busy = u.activity && u.activity.moves_left > 0 && u.activity.id() != ACT_AUTODRIVE;
+    if( !busy && !u.has_effect( effect_sleep ) ) {
+        return false;
+    }
+    // Hostiles count whether the player sees them or not, a sleeper would not
+    for( const shared_ptr_fast<monster> &critter :
+         critter_tracker->find_in_radius( u.pos(), MAX_VIEW_DISTANCE ) ) {
+        if( u.attitude_to( *critter ) == Creature::A_HOSTILE ) {
+            return false;
+        }
+    }
+    for( const npc &guy : all_npcs() ) {
+        if( rl_dist( guy.pos(), u.pos() ) <= MAX_VIEW_DISTANCE &&
+            u.attitude_to( guy ) == Creature::A_HOSTILE ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void game::update_player_body()
+{
+    fast_forwarding = can_fast_forward();
+    if( fast_forwarding ) {
+        fast_forwarded_turns++;
+    }
+    if( !fast_forwarding && !body_held_back_since ) {
+        u.update_body();
+        return;
+    }
+    // Same order as update_body, the rest is applied along with the rest of the minute
+    u.update_stamina( 1 );
+    if( fast_forwarding && !calendar::once_every( 1_minutes ) ) {
+        if( !body_held_back_since ) {
+            body_held_back_since = calendar::turn - 1_turns;
+        }
+    } else {
+        update_body_held_back();
+    }
+    u.do_skill_rust();
+}
+
+void game::update_body_held_back()
+{
+    if( body_held_back_since ) {
+        u.update_body_by_minute( *body_held_back_since, calendar::turn );
+        body_held_back_since = cata::nullopt;
+    }
+}
+
 void game::process_activity()
 {
     if( !u.activity ) {
@@ -2769,7 +2837,7 @@ void game::load_world_modfiles( loading_ui &ui )
     load_packs( _( "Loading files" ), mods, ui );
 
     // Load additional mods from that world-specific folder
-    load_data_from_dir( get_world_base_save_path() + "/mods", "custom", ui );
+    load_data_from_dir( get_world_base_save_path() + "/mods", "custom" );
 
     DynamicDataLoader::get_instance().finalize_loaded_data( ui );
 }
@@ -2792,7 +2860,7 @@ bool game::load_packs( const std::string &msg, const std::vector<mod_id> &packs,
     ui.show();
     for( const auto &e : available ) {
         const MOD_INFORMATION &mod = *e;
-        load_data_from_dir( mod.path, mod.ident.str(), ui );
+        load_data_from_dir( mod.path, mod.ident.str() );
         ui.proceed();
     }
 
@@ -2906,6 +2974,7 @@ spell_events &game::spell_events_subscriber()
 
 bool game::save()
 {
+    update_body_held_back();
     try {
         if( !save_player_data() ||
             !save_factions_missions_npcs() ||
@@ -4233,10 +4302,53 @@ void game::cleanup_dead()
     critter_died = false;
 }
 
+void game::plan_monster_sights()
+{
+    // Candidates are picked serially, the creature tracker is not safe to share
+    std::vector<monster *> planners;
+    std::vector<std::vector<Creature *>> candidates;
+    for( monster &critter : all_monsters() ) {
+        if( critter.is_dead() || critter.moves <= 0 ) {
+            continue;
+        }
+        std::vector<Creature *> seen = critter.sight_candidates();
+        if( !seen.empty() ) {
+            planners.push_back( &critter );
+            candidates.push_back( std::move( seen ) );
+        }
+    }
+    if( planners.empty() ) {
+        return;
+    }
+
+    // Fill in everything sees() would otherwise compute on demand
+    for( int z = 0; z <= OVERMAP_HEIGHT; z++ ) {
+        natural_light_level( z );
+    }
+    m.begin_target_sight_checks();
+    m.begin_parallel_sight_checks();
+    // Each task only writes to its own monster, and consumes no random numbers
+    thread_pool::run( planners.size(), [&]( const size_t i ) {
+        planners[i]->plan_sights( candidates[i] );
+    } );
+    m.end_parallel_sight_checks();
+    m.end_target_sight_checks();
+}
+
 void game::monmove()
 {
     cleanup_dead();
 
+    // Every monster rates every NPC as a target, so shadowcast from them once instead
+    m.clear_visibility_targets();
+    for( npc &guy : all_npcs() ) {
+        m.add_visibility_target( guy.pos() );
+    }
+
+    if( parallel_monster_planning ) {
+        plan_monster_sights();
+    }
+
     for( monster &critter : all_monsters() ) {
         // Critters in impassable tiles get pushed away, unless it's not impassable for them
         if( !critter.is_dead() && m.impassable( critter.pos() ) && !critter.can_move_to( critter.pos() ) ) {
@@ -4302,6 +4414,10 @@ void game::monmove()
 
     cleanup_dead();
 
+    for( monster &critter : all_monsters() ) {
+        critter.forget_planned_sights();
+    }
+
     // The remaining monsters are all alive, but may be outside of the reality bubble.
     // If so, despawn them. This is not the same as dying, they will be stored for later and the
     // monster::die function is not called.
@@ -4328,7 +4444,10 @@ void game::monmove()
                ( !guy.in_sleep_state() || guy.activity.id() == ACT_OPERATION )
              ) {
             int moves = guy.moves;
+            const auto move_start = std::chrono::steady_clock::now();
             guy.move();
+            guy.ai_time += std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::steady_clock::now() - move_start );
             if( moves == guy.moves ) {
                 // Count every time we exit npc::move() without spending any moves.
                 turns++;
@@ -11350,11 +11469,36 @@ void game::debug_hour_timer::print_time()
         if( calendar::once_every( time_duration::from_hours( 1 ) ) ) {
             const IRLTimeMs now = std::chrono::time_point_cast<std::chrono::milliseconds>(
                                       std::chrono::system_clock::now() );
+            route_cache_stats &routes = get_route_cache_stats();
+            npc_perception &perception = get_npc_perception();
             if( start_time ) {
                 add_msg( "in-game hour took: %d ms", ( now - *start_time ).count() );
+                add_msg( "fast-forwarded turns: %d", g->fast_forwarded_turns );
+                add_msg( "creature paths: %d reused, %d repaired, %d searched",
+                         routes.hits, routes.repairs, routes.misses );
+                add_msg( "NPC searches: %d done, %d put off", perception.searches, perception.postponed );
+                std::vector<const npc *> npcs;
+                for( const npc &guy : g->all_npcs() ) {
+                    npcs.push_back( &guy );
+                }
+                std::sort( npcs.begin(), npcs.end(), []( const npc * lhs, const npc * rhs ) {
+                    return lhs->ai_time > rhs->ai_time;
+                } );
+                // The slowest few
+                for( size_t i = 0; i < npcs.size() && i < 5; i++ ) {
+                    add_msg( "NPC %s took: %d ms", npcs[i]->name,
+                             std::chrono::duration_cast<std::chrono::milliseconds>( npcs[i]->ai_time ).count() );
+                }
             } else {
                 add_msg( "starting debug timer" );
             }
+            routes = route_cache_stats();
+            g->fast_forwarded_turns = 0;
+            perception.searches = 0;
+            perception.postponed = 0;
+            for( npc &guy : g->all_npcs() ) {
+                guy.ai_time = std::chrono::microseconds::zero();
+            }
             start_time = now;
         }
     }
@@ -12055,6 +12199,18 @@ std::vector<Creature *> game::get_creatures_if( const std::function<bool( const
     return result;
 }
 
+std::vector<Creature *> game::get_creatures_in_range_if( const tripoint &center, const int range,
+        const std::function<bool( const Creature & )> &pred )
+{
+    std::vector<Creature *> result;
+    for( Creature &critter : creatures_in_range( center, range ) ) {
+        if( pred( critter ) ) {
+            result.push_back( &critter );
+        }
+    }
+    return result;
+}
+
 std::vector<npc *> game::get_npcs_if( const std::function<bool( const npc & )> &pred )
 {
     std::vector<npc *> result;
@@ -12105,6 +12261,11 @@ game::monster_range::monster_range( game &game_ref )
     items.insert( items.end(), monsters.begin(), monsters.end() );
 }
 
+game::monster_range::monster_range( const std::vector<shared_ptr_fast<monster>> &monsters )
+{
+    items.insert( items.end(), monsters.begin(), monsters.end() );
+}
+
 game::Creature_range::Creature_range( game &game_ref ) : u( &game_ref.u, []( player * ) { } )
 {
     const auto &monsters = game_ref.critter_tracker->get_monsters_list();
@@ -12113,6 +12274,27 @@ game::Creature_range::Creature_range( game &game_ref ) : u( &game_ref.u, []( pla
     items.push_back( u );
 }
 
+game::Creature_range::Creature_range( game &game_ref, const tripoint &center, const int range ) :
+    u( &game_ref.u, []( player * ) { } )
+{
+    const tripoint min = center - tripoint( range, range, range );
+    const tripoint max = center + tripoint( range, range, range );
+    const auto in_range = [&]( const tripoint & p ) {
+        return p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+               p.x <= max.x && p.y <= max.y && p.z <= max.z;
+    };
+    const auto monsters = game_ref.critter_tracker->find_in_cuboid( min, max );
+    items.insert( items.end(), monsters.begin(), monsters.end() );
+    for( const shared_ptr_fast<npc> &guy : game_ref.active_npc ) {
+        if( in_range( guy->pos() ) ) {
+            items.push_back( guy );
+        }
+    }
+    if( in_range( game_ref.u.pos() ) ) {
+        items.push_back( u );
+    }
+}
+
 game::npc_range::npc_range( game &game_ref )
 {
     items.insert( items.end(), game_ref.active_npc.begin(), game_ref.active_npc.end() );
@@ -12133,6 +12315,22 @@ game::npc_range game::all_npcs()
     return npc_range( *this );
 }
 
+game::Creature_range game::creatures_in_range( const tripoint &center, const int range )
+{
+    return Creature_range( *this, center, range );
+}
+
+game::monster_range game::monsters_in_radius( const tripoint &center, const int radius )
+{
+    return monster_range( critter_tracker->find_in_radius( center, radius ) );
+}
+
+game::monster_range game::monsters_in_cone( const tripoint &origin, const units::angle direction,
+        const units::angle spread, const int range )
+{
+    return monster_range( critter_tracker->find_in_cone( origin, direction, spread, range ) );
+}
+
 Creature *game::get_creature_if( const std::function<bool( const Creature & )> &pred )
 {
     for( Creature &critter : all_creatures() ) {
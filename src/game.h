@@ -159,7 +159,7 @@ class game
         void load_static_data();
 
         /** Loads core dynamic data. May throw. */
-        void load_core_data( loading_ui &ui );
+        void load_core_data();
 
         /** Returns whether the core data is currently loaded. */
         bool is_core_data_loaded() const;
@@ -199,7 +199,7 @@ class game
 
     protected:
         /** Loads dynamic data from the given directory. May throw. */
-        void load_data_from_dir( const std::string &path, const std::string &src, loading_ui &ui );
+        void load_data_from_dir( const std::string &path, const std::string &src );
     public:
         void setup();
         /** Saving and loading functions. */
@@ -411,6 +411,7 @@ class game
         {
             public:
                 monster_range( game &game_ref );
+                monster_range( const std::vector<shared_ptr_fast<monster>> &monsters );
         };
 
         class npc_range : public non_dead_range<npc>
@@ -426,6 +427,7 @@ class game
 
             public:
                 Creature_range( game &game_ref );
+                Creature_range( game &game_ref, const tripoint &center, int range );
         };
 
     public:
@@ -441,12 +443,27 @@ class game
         monster_range all_monsters();
         /// Same as @ref all_creatures but iterators only over npcs.
         npc_range all_npcs();
+        /**
+         * Same as @ref all_creatures but iterates only over the creatures that are at most
+         * @p range tiles away from @p center along each axis, which includes everything within
+         * @p range by any of the distance measures. Monsters are looked up through the spatial
+         * index of the creature tracker instead of going through all of them.
+         */
+        Creature_range creatures_in_range( const tripoint &center, int range );
+        /// Same as @ref all_monsters but iterates only over @ref Creature_tracker::find_in_radius.
+        monster_range monsters_in_radius( const tripoint &center, int radius );
+        /// Same as @ref all_monsters but iterates only over @ref Creature_tracker::find_in_cone.
+        monster_range monsters_in_cone( const tripoint &origin, units::angle direction,
+                                        units::angle spread, int range );
 
         /**
          * Returns all creatures matching a predicate. Only living ( not dead ) creatures
          * are checked ( and returned ). Returned pointers are never null.
          */
         std::vector<Creature *> get_creatures_if( const std::function<bool( const Creature & )> &pred );
+        /** Same as @ref get_creatures_if but only checks @ref creatures_in_range. */
+        std::vector<Creature *> get_creatures_in_range_if( const tripoint &center, int range,
+                const std::function<bool( const Creature & )> &pred );
         std::vector<npc *> get_npcs_if( const std::function<bool( const npc & )> &pred );
         /**
          * Returns a creature matching a predicate. Only living (not dead) creatures
@@ -838,6 +855,20 @@ class game
                        int hor_padding = 0 ); // Prints a list of nearby monsters
         void mon_info_update( );    //Update seen monsters information
         void cleanup_dead();     // Delete any dead NPCs/monsters
+        void monmove();          // Monster movement
+        // Checks ahead of monmove which creatures each monster sees, on the worker threads
+        void plan_monster_sights();
+        /**
+         * Whether this turn can be fast-forwarded: the player is asleep or busy with an
+         * activity and there is no hostile around, so nothing needs to be shown or done
+         * for the player turn by turn.
+         */
+        bool can_fast_forward();
+        /**
+         * Updates the player's body for this turn. While fast-forwarding, everything but
+         * stamina and skill rust is held back and applied once a minute.
+         */
+        void update_player_body();
         bool is_dangerous_tile( const tripoint &dest_loc ) const;
         std::vector<std::string> get_dangerous_tile( const tripoint &dest_loc ) const;
         bool prompt_dangerous_tile( const tripoint &dest_loc ) const;
@@ -893,10 +924,11 @@ class game
         void perhaps_add_random_npc();
 
         // Routine loop functions, approximately in order of execution
-        void monmove();          // Monster movement
         void overmap_npc_move(); // NPC overmap movement
         void process_voluntary_act_interrupt(); // Process
         void process_activity(); // Processes and enacts the player's activity
+        /** Applies the changes to the player's body held back by fast-forwarding. */
+        void update_body_held_back();
         void handle_key_blocking_activity(); // Abort reading etc.
         void open_consume_item_menu(); // Custom menu for consuming specific group of items
         bool handle_action();
@@ -951,7 +983,8 @@ class game
         void display_radiation(); // Displays radiation map
         void display_transparency(); // Displays transparency map
 
-        // prints the IRL time in ms of the last full in-game hour
+        // prints the IRL time in ms of the last full in-game hour, how much of it was
+        // fast-forwarded, how creature paths were found and the time NPCs took to decide what to do
         class debug_hour_timer
         {
             public:
@@ -1079,6 +1112,12 @@ class game
         bool critter_died = false;
         /** Is this the first redraw since waiting (sleeping or activity) started */
         bool first_redraw_since_waiting_started = true;
+        /** Is the current turn fast-forwarded, see @ref can_fast_forward */
+        bool fast_forwarding = false;
+        /** Number of turns fast-forwarded since the debug hour timer last reported it */
+        int fast_forwarded_turns = 0;
+        /** First turn whose changes to the player's body were held back by fast-forwarding */
+        cata::optional<time_point> body_held_back_since;
         /** Is Zone manager open or not - changes graphics of some zone tiles */
         bool zones_manager_open = false;
 
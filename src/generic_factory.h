@@ -4,8 +4,11 @@
 
 #include <algorithm>
 #include <bitset>
+#include <cstdint>
+#include <functional>
 #include <set>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "assign.h"
@@ -153,20 +156,78 @@ class generic_factory
         // TEMPORARY until 0.G: Remove "ident" support
         const std::string legacy_id_member_name = "ident";
 
+        // Read-only copy of `map` as an open addressing table, built by finalize() and
+        // dropped on the next change. Used instead of `map` while it exists, saves chasing
+        // the nodes of the unordered_map when looking up ids that have no cached `_cid` yet.
+        std::vector<std::pair<string_id<T>, int_id<T>>> frozen_map;
+        int frozen_shift = 0;
+
+        size_t frozen_slot( const string_id<T> &id ) const {
+            // Fibonacci hashing, spreads the consecutive interned string numbers over the table.
+            const uint64_t h = static_cast<uint64_t>( std::hash<string_id<T>>()( id ) );
+            return static_cast<size_t>( ( h * 11400714819323198485ULL ) >> frozen_shift );
+        }
+
+        void freeze() {
+            if( map.empty() ) {
+                unfreeze();
+                return;
+            }
+            size_t capacity = 1;
+            frozen_shift = 64;
+            // Keep the load factor at or below one half, so there are always empty slots.
+            while( capacity < map.size() * 2 ) {
+                capacity *= 2;
+                frozen_shift--;
+            }
+            frozen_map.assign( capacity, std::make_pair( string_id<T>(), int_id<T>( INVALID_CID ) ) );
+            for( const auto &e : map ) {
+                size_t i = frozen_slot( e.first );
+                while( frozen_map[i].second.to_i() != INVALID_CID ) {
+                    i = ( i + 1 ) & ( capacity - 1 );
+                }
+                frozen_map[i] = e;
+            }
+        }
+
+        void unfreeze() {
+            frozen_map.clear();
+        }
+
+        bool lookup( const string_id<T> &id, int_id<T> &result ) const {
+            if( frozen_map.empty() ) {
+                const auto iter = map.find( id );
+                if( iter == map.end() ) {
+                    return false;
+                }
+                result = iter->second;
+                return true;
+            }
+            const size_t mask = frozen_map.size() - 1;
+            for( size_t i = frozen_slot( id ); ; i = ( i + 1 ) & mask ) {
+                const std::pair<string_id<T>, int_id<T>> &slot = frozen_map[i];
+                if( slot.second.to_i() == INVALID_CID ) {
+                    return false;
+                }
+                if( slot.first == id ) {
+                    result = slot.second;
+                    return true;
+                }
+            }
+        }
+
         bool find_id( const string_id<T> &id, int_id<T> &result ) const {
             if( id._version == version ) {
                 result = int_id<T>( id._cid );
                 return is_valid( result );
             }
 
-            const auto iter = map.find( id );
             // map lookup happens at most once per string_id instance per generic_factory::version
             // id was not found, explicitly marking it as "invalid"
-            if( iter == map.end() ) {
+            if( !lookup( id, result ) ) {
                 id.set_cid_version( INVALID_CID, version );
                 return false;
             }
-            result = iter->second;
             id.set_cid_version( result.to_i(), version );
             return true;
         }
@@ -176,6 +237,7 @@ class generic_factory
             if( !find_id( id, i_id ) ) {
                 return;
             }
+            unfreeze();
             auto iter = map.begin();
             const auto end = map.end();
             for( ; iter != end; ) {
@@ -358,6 +420,7 @@ class generic_factory
             // in the common scenario there is no loss of performance, as `finalize` will make cache
             // for all ids valid again
             inc_version();
+            unfreeze();
             const auto iter = map.find( obj.id );
             if( iter != map.end() ) {
                 T &result = list[iter->second.to_i()];
@@ -388,6 +451,7 @@ class generic_factory
             for( size_t i = 0; i < list.size(); i++ ) {
                 list[i].id.set_cid_version( static_cast<int>( i ), version );
             }
+            freeze();
             set_finalized( true );
         }
 
@@ -418,6 +482,7 @@ class generic_factory
         void reset() {
             set_finalized( false );
             inc_version();
+            unfreeze();
             list.clear();
             map.clear();
             abstracts.clear();
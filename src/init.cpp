@@ -1,7 +1,9 @@
 #include "init.h"
 
 #include <cassert>
+#include <chrono>
 #include <cstddef>
+#include <deque>
 #include <exception>
 #include <fstream>
 #include <iterator>
@@ -90,6 +92,7 @@
 #include "start_location.h"
 #include "string_formatter.h"
 #include "text_snippets.h"
+#include "thread_pool.h"
 #include "translations.h"
 #include "trap.h"
 #include "type_id.h"
@@ -457,8 +460,65 @@ void DynamicDataLoader::initialize()
 #endif
 }
 
-void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src,
-        loading_ui &ui )
+namespace
+{
+
+// A data file split into its top level objects, waiting to be handed to the loaders.
+struct parsed_json_file {
+    std::string data;
+    std::unique_ptr<JsonIn> jsin;
+    // A deque, so the objects are never copied (which would report their members as unvisited).
+    std::deque<JsonObject> objects;
+    // Syntax error found after the objects above, reported once they have been loaded.
+    std::string error;
+};
+
+} // namespace
+
+static void parse_json_file( const std::string &file, parsed_json_file &result )
+{
+    cata_ifstream infile = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( file ) );
+    result.data.assign( std::istreambuf_iterator<char>( *infile ), std::istreambuf_iterator<char>() );
+    result.jsin = std::make_unique<JsonIn>( result.data.data(), result.data.size(), file );
+    JsonIn &jsin = *result.jsin;
+    try {
+        // TEMPORARY until 0.G: Remove single object support for consistency
+        if( jsin.test_object() ) {
+            result.objects.emplace_back( jsin );
+            // if there's anything else in the file, it's an error.
+            jsin.eat_whitespace();
+            if( jsin.good() ) {
+                jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
+            }
+        } else if( jsin.test_array() ) {
+            jsin.start_array();
+            while( !jsin.end_array() ) {
+                result.objects.emplace_back( jsin );
+            }
+        } else {
+            // not an object or an array?
+            jsin.error( "expected object or array" );
+        }
+    } catch( const JsonError &err ) {
+        result.error = err.what();
+    }
+}
+
+/**
+ * Reads and splits the files on the thread pool. Parsing does not touch any global
+ * state, each file (and everything referring to its JsonIn) belongs to a single task
+ * until it is handed back.
+ */
+static std::vector<parsed_json_file> parse_json_files( const std::vector<std::string> &files )
+{
+    std::vector<parsed_json_file> parsed( files.size() );
+    thread_pool::run( files.size(), [&]( size_t i ) {
+        parse_json_file( files[i], parsed[i] );
+    } );
+    return parsed;
+}
+
+void DynamicDataLoader::load_data_from_path( const std::string &path, const std::string &src )
 {
     assert( !finalized && "Can't load additional data after finalization.  Must be unloaded first." );
     // We assume that each folder is consistent in itself,
@@ -477,55 +537,32 @@ void DynamicDataLoader::load_data_from_path( const std::string &path, const std:
             files.push_back( path );
         }
     }
-    // iterate over each file
-    for( auto &files_i : files ) {
-        const std::string &file = files_i;
-        // open the file as a stream
-        cata_ifstream infile = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( file ) );
-        // and stuff it into ram
-        std::istringstream iss(
-            std::string(
-                ( std::istreambuf_iterator<char>( *infile ) ),
-                std::istreambuf_iterator<char>()
-            )
-        );
+    const auto parse_start = std::chrono::steady_clock::now();
+    std::vector<parsed_json_file> parsed = parse_json_files( files );
+    const auto dispatch_start = std::chrono::steady_clock::now();
+
+    // Objects are handed to the loaders in the same order as they appear in the sorted file list.
+    for( size_t i = 0; i < files.size(); ++i ) {
         try {
-            // parse it
-            JsonIn jsin( iss, file );
-            load_all_from_json( jsin, src, ui, path, file );
+            for( JsonObject &jo : parsed[i].objects ) {
+                load_object( jo, src, path, files[i] );
+                jo.finish();
+            }
+            if( !parsed[i].error.empty() ) {
+                throw std::runtime_error( parsed[i].error );
+            }
         } catch( const JsonError &err ) {
             throw std::runtime_error( err.what() );
         }
+        inp_mngr.pump_events();
     }
-}
 
-void DynamicDataLoader::load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &,
-        const std::string &base_path, const std::string &full_path )
-{
-    // TEMPORARY until 0.G: Remove single object support for consistency
-    if( jsin.test_object() ) {
-        // find type and dispatch single object
-        JsonObject jo = jsin.get_object();
-        load_object( jo, src, base_path, full_path );
-        jo.finish();
-        // if there's anything else in the file, it's an error.
-        jsin.eat_whitespace();
-        if( jsin.good() ) {
-            jsin.error( string_format( "expected single-object file but found '%c'", jsin.peek() ) );
-        }
-    } else if( jsin.test_array() ) {
-        jsin.start_array();
-        // find type and dispatch each object until array close
-        while( !jsin.end_array() ) {
-            JsonObject jo = jsin.get_object();
-            load_object( jo, src, base_path, full_path );
-            jo.finish();
-        }
-    } else {
-        // not an object or an array?
-        jsin.error( "expected object or array" );
-    }
-    inp_mngr.pump_events();
+    const auto dispatch_end = std::chrono::steady_clock::now();
+    DebugLog( DL::Info, DC::Main ) << string_format(
+                                       "Loaded %d files from \"%s\": parsing took %d ms, loading %d ms",
+                                       files.size(), path,
+                                       std::chrono::duration_cast<std::chrono::milliseconds>( dispatch_start - parse_start ).count(),
+                                       std::chrono::duration_cast<std::chrono::milliseconds>( dispatch_end - dispatch_start ).count() );
 }
 
 void DynamicDataLoader::unload_data()
@@ -808,6 +845,10 @@ void DynamicDataLoader::check_consistency( loading_ui &ui )
     }
 
     ui.show();
+    // The checks run one after another: they look up string_ids (which cache their
+    // index), can create runtime item types and report problems through debugmsg,
+    // none of which is safe from several threads. Use --profile-startup to see
+    // what each of them costs.
     for( const named_entry &e : entries ) {
         e.second();
         ui.proceed();
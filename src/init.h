@@ -84,17 +84,6 @@ class DynamicDataLoader
         void add( const std::string &type,
                   std::function<void( const JsonObject &, const std::string &, const std::string &, const std::string & )>
                   f );
-        /**
-         * Load all the types from that json data.
-         * @param jsin Might contain single object,
-         * or an array of objects. Each object must have a
-         * "type", that is part of the @ref type_function_map
-         * @param src String identifier for mod this data comes from
-         * @param ui Finalization status display.
-         * @throws std::exception on all kind of errors.
-         */
-        void load_all_from_json( JsonIn &jsin, const std::string &src, loading_ui &ui,
-                                 const std::string &base_path, const std::string &full_path );
         /**
          * Load a single object from a json object.
          * @param jo The json object to load the C++-object from.
@@ -130,11 +119,10 @@ class DynamicDataLoader
          * files with the extension .json), or a file (load only
          * that file, don't check extension).
          * @param src String identifier for mod this data comes from
-         * @param ui Finalization status display.
          * @throws std::exception on all kind of errors.
          */
         /*@{*/
-        void load_data_from_path( const std::string &path, const std::string &src, loading_ui &ui );
+        void load_data_from_path( const std::string &path, const std::string &src );
         /*@}*/
         /**
          * Deletes and unloads all the data previously loaded with
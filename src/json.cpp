@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <bitset>
+#include <charconv>
 #include <cmath> // pow
 #include <cstdint>
 #include <cstdio>
@@ -14,6 +15,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
 
@@ -31,6 +33,14 @@ static bool is_whitespace( char ch )
     return ( ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' );
 }
 
+// Characters that can be copied into a string value as they are. Anything else
+// has to go through get_escaped_or_unicode.
+static bool is_plain_string_char( char ch )
+{
+    const unsigned char uc = static_cast<unsigned char>( ch );
+    return uc >= 0x20 && uc < 0x80 && ch != '"' && ch != '\\';
+}
+
 // for parsing \uxxxx escapes
 static std::string utf16_to_utf8( uint32_t ch )
 {
@@ -725,6 +735,82 @@ void add_array_to_set( std::set<std::string> &s, const JsonObject &json, const s
     }
 }
 
+/**
+ * Input stream over a block of memory that is neither owned nor copied.
+ * Unlike with std::istringstream, seeking is a plain pointer adjustment and
+ * the unread data can be scanned directly.
+ */
+class JsonIn::memory_source
+{
+    private:
+        class buffer_type : public std::streambuf
+        {
+            public:
+                buffer_type( const char *data, size_t size ) {
+                    // The get area is never written to, so casting away const is fine.
+                    char *begin = const_cast<char *>( data );
+                    setg( begin, begin, begin + size );
+                }
+
+                const char *current() const {
+                    return gptr();
+                }
+                const char *end() const {
+                    return egptr();
+                }
+                void advance( std::ptrdiff_t n ) {
+                    setg( eback(), gptr() + n, egptr() );
+                }
+
+            protected:
+                pos_type seekoff( off_type off, std::ios_base::seekdir dir,
+                                  std::ios_base::openmode which ) override {
+                    char *base = dir == std::ios_base::beg ? eback() :
+                                 dir == std::ios_base::cur ? gptr() : egptr();
+                    if( !( which & std::ios_base::in ) || off < eback() - base || off > egptr() - base ) {
+                        return pos_type( off_type( -1 ) );
+                    }
+                    setg( eback(), base + off, egptr() );
+                    return pos_type( gptr() - eback() );
+                }
+                pos_type seekpos( pos_type pos, std::ios_base::openmode which ) override {
+                    return seekoff( off_type( pos ), std::ios_base::beg, which );
+                }
+        };
+
+    public:
+        buffer_type buffer;
+        std::istream stream;
+
+        memory_source( const char *data, size_t size ) : buffer( data, size ), stream( &buffer ) {}
+};
+
+JsonIn::JsonIn( std::istream &s ) : stream( &s ) {}
+
+JsonIn::JsonIn( std::istream &s, const std::string &path )
+    : stream( &s ), path( make_shared_fast<std::string>( path ) ) {}
+
+JsonIn::JsonIn( std::istream &s, const json_source_location &loc )
+    : stream( &s ), path( loc.path )
+{
+    seek( loc.offset );
+}
+
+JsonIn::JsonIn( const char *data, size_t size )
+    : memory( std::make_unique<memory_source>( data, size ) )
+{
+    stream = &memory->stream;
+}
+
+JsonIn::JsonIn( const char *data, size_t size, const std::string &path )
+    : path( make_shared_fast<std::string>( path ) ),
+      memory( std::make_unique<memory_source>( data, size ) )
+{
+    stream = &memory->stream;
+}
+
+JsonIn::~JsonIn() = default;
+
 int JsonIn::tell()
 {
     return stream->tellg();
@@ -747,8 +833,56 @@ void JsonIn::seek( int pos )
 
 void JsonIn::eat_whitespace()
 {
-    while( is_whitespace( peek() ) ) {
-        stream->get();
+    if( !stream->good() ) {
+        // Keep the stream state the same as peek() would leave it.
+        peek();
+        return;
+    }
+    // Going through the stream buffer directly avoids the overhead of the
+    // std::istream functions, which adds up for every single character.
+    std::streambuf &buf = *stream->rdbuf();
+    int ch = buf.sgetc();
+    while( ch != EOF && is_whitespace( static_cast<char>( ch ) ) ) {
+        ch = buf.snextc();
+    }
+    if( ch == EOF ) {
+        stream->setstate( std::ios_base::eofbit );
+    }
+}
+
+void JsonIn::read_char( char &ch )
+{
+    if( !stream->good() ) {
+        stream->setstate( std::ios_base::failbit );
+        ch = '\0';
+        return;
+    }
+    const int next = stream->rdbuf()->sbumpc();
+    if( next == EOF ) {
+        stream->setstate( std::ios_base::eofbit | std::ios_base::failbit );
+        ch = '\0';
+        return;
+    }
+    ch = static_cast<char>( next );
+}
+
+void JsonIn::read_plain_chars( std::string &s )
+{
+    if( memory ) {
+        const char *const begin = memory->buffer.current();
+        const char *const limit = memory->buffer.end();
+        const char *end = begin;
+        while( end != limit && is_plain_string_char( *end ) ) {
+            ++end;
+        }
+        s.append( begin, end );
+        memory->buffer.advance( end - begin );
+        return;
+    }
+    std::streambuf &buf = *stream->rdbuf();
+    for( int ch = buf.sgetc(); ch != EOF && is_plain_string_char( static_cast<char>( ch ) );
+         ch = buf.snextc() ) {
+        s += static_cast<char>( ch );
     }
 }
 
@@ -833,7 +967,12 @@ void JsonIn::skip_string()
         err << "expecting string but found '" << ch << "'";
         error( err.str(), -1 );
     }
+    std::streambuf &buf = *stream->rdbuf();
     while( stream->good() ) {
+        // Plain characters can't end the string, skip them without going through the stream.
+        for( int next = buf.sgetc(); next != EOF && is_plain_string_char( static_cast<char>( next ) ); ) {
+            next = buf.snextc();
+        }
         stream->get( ch );
         if( ch == '\\' ) {
             stream->get( ch );
@@ -1111,8 +1250,9 @@ std::string JsonIn::get_string()
             err = "expected string but got '" + std::string( 1, ch ) + "'";
             break;
         }
-        // add chars to the string, one at a time
+        // add chars to the string, plain ones in bulk, the others one at a time
         do {
+            read_plain_chars( s );
             ch = stream->peek();
             if( !stream->good() ) {
                 err = "read operation failed";
@@ -1274,9 +1414,9 @@ number_sci_notation JsonIn::get_any_number()
     number_sci_notation ret;
     int mod_e = 0;
     eat_whitespace();
-    stream->get( ch );
+    read_char( ch );
     if( ( ret.negative = ch == '-' ) ) {
-        stream->get( ch );
+        read_char( ch );
     } else if( ch != '.' && ( ch < '0' || ch > '9' ) ) {
         // not a valid float
         std::stringstream err;
@@ -1285,7 +1425,7 @@ number_sci_notation JsonIn::get_any_number()
     }
     if( ch == '0' ) {
         // allow a single leading zero in front of a '.' or 'e'/'E'
-        stream->get( ch );
+        read_char( ch );
         if( ch >= '0' && ch <= '9' ) {
             error( "leading zeros not allowed", -1 );
         }
@@ -1293,29 +1433,29 @@ number_sci_notation JsonIn::get_any_number()
     while( ch >= '0' && ch <= '9' ) {
         ret.number *= 10;
         ret.number += ( ch - '0' );
-        stream->get( ch );
+        read_char( ch );
     }
     if( ch == '.' ) {
-        stream->get( ch );
+        read_char( ch );
         while( ch >= '0' && ch <= '9' ) {
             ret.number *= 10;
             ret.number += ( ch - '0' );
             mod_e -= 1;
-            stream->get( ch );
+            read_char( ch );
         }
     }
     if( ch == 'e' || ch == 'E' ) {
-        stream->get( ch );
+        read_char( ch );
         bool neg;
         if( ( neg = ch == '-' ) ) {
-            stream->get( ch );
+            read_char( ch );
         } else if( ch == '+' ) {
-            stream->get( ch );
+            read_char( ch );
         }
         while( ch >= '0' && ch <= '9' ) {
             ret.exp *= 10;
             ret.exp += ( ch - '0' );
-            stream->get( ch );
+            read_char( ch );
         }
         if( neg ) {
             ret.exp *= -1;
@@ -1851,13 +1991,83 @@ JsonOut::JsonOut( std::ostream &s, bool pretty, int depth ) :
     stream->setf( std::ios_base::boolalpha );
 }
 
+JsonOut::~JsonOut()
+{
+    // Only reached with data left in the buffer if a value was not finished,
+    // write it out anyway without going through the (possibly throwing) stream.
+    if( !buffer.empty() ) {
+        stream->rdbuf()->sputn( buffer.data(), buffer.size() );
+    }
+}
+
+void JsonOut::flush()
+{
+    if( !buffer.empty() ) {
+        stream->write( buffer.data(), buffer.size() );
+        buffer.clear();
+    }
+}
+
+void JsonOut::end_value()
+{
+    need_separator = true;
+    // Large files are written in chunks, everything else once the top level value is done.
+    static constexpr size_t flush_threshold = 64 * 1024;
+    if( need_wrap.empty() || buffer.size() >= flush_threshold ) {
+        flush();
+    }
+}
+
+void JsonOut::write_integer( long long val )
+{
+    char buf[24];
+    const std::to_chars_result result = std::to_chars( buf, buf + sizeof( buf ), val );
+    buffer.append( buf, result.ptr );
+}
+
+void JsonOut::write_integer( unsigned long long val )
+{
+    char buf[24];
+    const std::to_chars_result result = std::to_chars( buf, buf + sizeof( buf ), val );
+    buffer.append( buf, result.ptr );
+}
+
+// Same output as the stream with the flags set in the constructor (fixed, precision 6).
+void JsonOut::write_float( double val )
+{
+#if defined(__cpp_lib_to_chars)
+    char buf[384];
+    const std::to_chars_result result = std::to_chars( buf, buf + sizeof( buf ), val,
+                                        std::chars_format::fixed, 6 );
+    if( result.ec == std::errc() ) {
+        buffer.append( buf, result.ptr );
+        return;
+    }
+#endif
+    flush();
+    *stream << val;
+}
+
+void JsonOut::write_float( long double val )
+{
+    flush();
+    *stream << val;
+}
+
+void JsonOut::write_newline()
+{
+    buffer += '\n';
+}
+
 int JsonOut::tell()
 {
+    flush();
     return stream->tellp();
 }
 
 void JsonOut::seek( int pos )
 {
+    flush();
     stream->clear();
     stream->seekp( pos );
     need_separator = false;
@@ -1865,7 +2075,7 @@ void JsonOut::seek( int pos )
 
 void JsonOut::write_indent()
 {
-    std::fill_n( std::ostream_iterator<char>( *stream ), indent_level * 2, ' ' );
+    buffer.append( indent_level * 2, ' ' );
 }
 
 void JsonOut::write_separator()
@@ -1873,15 +2083,15 @@ void JsonOut::write_separator()
     if( !need_separator ) {
         return;
     }
-    stream->put( ',' );
+    buffer += ',';
     if( pretty_print ) {
         // Wrap after seperator between objects and between members of top-level objects.
         if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
+            buffer += '\n';
             write_indent();
         } else {
             // Otherwise pad after commas.
-            stream->put( ' ' );
+            buffer += ' ';
         }
     }
     need_separator = false;
@@ -1890,9 +2100,9 @@ void JsonOut::write_separator()
 void JsonOut::write_member_separator()
 {
     if( pretty_print ) {
-        stream->write( ": ", 2 );
+        buffer += ": ";
     } else {
-        stream->put( ':' );
+        buffer += ':';
     }
     need_separator = false;
 }
@@ -1903,11 +2113,11 @@ void JsonOut::start_pretty()
         indent_level += 1;
         // Wrap after top level object and array opening.
         if( indent_level < 2 || need_wrap.back() ) {
-            stream->put( '\n' );
+            buffer += '\n';
             write_indent();
         } else {
             // Otherwise pad after opening.
-            stream->put( ' ' );
+            buffer += ' ';
         }
     }
 }
@@ -1919,11 +2129,11 @@ void JsonOut::end_pretty()
         // Wrap after ending top level array and object.
         // Also wrap in the special case of exiting an array containing an object.
         if( indent_level < 1 || need_wrap.back() ) {
-            stream->put( '\n' );
+            buffer += '\n';
             write_indent();
         } else {
             // Otherwise pad after ending.
-            stream->put( ' ' );
+            buffer += ' ';
         }
     }
 }
@@ -1933,7 +2143,7 @@ void JsonOut::start_object( bool wrap )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '{' );
+    buffer += '{';
     need_wrap.push_back( wrap );
     start_pretty();
     need_separator = false;
@@ -1943,8 +2153,8 @@ void JsonOut::end_object()
 {
     end_pretty();
     need_wrap.pop_back();
-    stream->put( '}' );
-    need_separator = true;
+    buffer += '}';
+    end_value();
 }
 
 void JsonOut::start_array( bool wrap )
@@ -1952,7 +2162,7 @@ void JsonOut::start_array( bool wrap )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '[' );
+    buffer += '[';
     need_wrap.push_back( wrap );
     start_pretty();
     need_separator = false;
@@ -1962,8 +2172,8 @@ void JsonOut::end_array()
 {
     end_pretty();
     need_wrap.pop_back();
-    stream->put( ']' );
-    need_separator = true;
+    buffer += ']';
+    end_value();
 }
 
 void JsonOut::write_null()
@@ -1971,8 +2181,8 @@ void JsonOut::write_null()
     if( need_separator ) {
         write_separator();
     }
-    stream->write( "null", 4 );
-    need_separator = true;
+    buffer += "null";
+    end_value();
 }
 
 void JsonOut::write( const std::string &val )
@@ -1980,42 +2190,45 @@ void JsonOut::write( const std::string &val )
     if( need_separator ) {
         write_separator();
     }
-    stream->put( '"' );
+    buffer += '"';
+    const char *plain_begin = val.data();
     for( const auto &i : val ) {
         unsigned char ch = i;
+        if( ch >= 0x20 && ch != '"' && ch != '\\' ) {
+            // copied in one go with its neighbours below
+            continue;
+        }
+        buffer.append( plain_begin, &i );
+        plain_begin = &i + 1;
         if( ch == '"' ) {
-            stream->write( "\\\"", 2 );
+            buffer += "\\\"";
         } else if( ch == '\\' ) {
-            stream->write( "\\\\", 2 );
-        } else if( ch == '/' ) {
-            // don't technically need to escape this
-            stream->put( '/' );
+            buffer += "\\\\";
         } else if( ch == '\b' ) {
-            stream->write( "\\b", 2 );
+            buffer += "\\b";
         } else if( ch == '\f' ) {
-            stream->write( "\\f", 2 );
+            buffer += "\\f";
         } else if( ch == '\n' ) {
-            stream->write( "\\n", 2 );
+            buffer += "\\n";
         } else if( ch == '\r' ) {
-            stream->write( "\\r", 2 );
+            buffer += "\\r";
         } else if( ch == '\t' ) {
-            stream->write( "\\t", 2 );
+            buffer += "\\t";
         } else if( ch < 0x20 ) {
             // convert to "\uxxxx" unicode escape
-            stream->write( "\\u00", 4 );
-            stream->put( ( ch < 0x10 ) ? '0' : '1' );
+            buffer += "\\u00";
+            buffer += ( ch < 0x10 ) ? '0' : '1';
             char remainder = ch & 0x0F;
             if( remainder < 0x0A ) {
-                stream->put( '0' + remainder );
+                buffer += static_cast<char>( '0' + remainder );
             } else {
-                stream->put( 'A' + ( remainder - 0x0A ) );
+                buffer += static_cast<char>( 'A' + ( remainder - 0x0A ) );
             }
-        } else {
-            stream->put( ch );
         }
     }
-    stream->put( '"' );
-    need_separator = true;
+    buffer.append( plain_begin, val.data() + val.size() );
+    buffer += '"';
+    end_value();
 }
 
 template<size_t N>
@@ -2024,14 +2237,10 @@ void JsonOut::write( const std::bitset<N> &b )
     if( need_separator ) {
         write_separator();
     }
-    std::string converted = b.to_string();
-    stream->put( '"' );
-    for( auto &i : converted ) {
-        unsigned char ch = i;
-        stream->put( ch );
-    }
-    stream->put( '"' );
-    need_separator = true;
+    buffer += '"';
+    buffer += b.to_string();
+    buffer += '"';
+    end_value();
 }
 
 void JsonOut::write( const JsonSerializer &thing )
@@ -2040,7 +2249,7 @@ void JsonOut::write( const JsonSerializer &thing )
         write_separator();
     }
     thing.serialize( *this );
-    need_separator = true;
+    end_value();
 }
 
 void JsonOut::member( const std::string &name )
@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -176,24 +177,37 @@ struct json_source_location {
 class JsonIn
 {
     private:
+        class memory_source;
+
         std::istream *stream;
         shared_ptr_fast<std::string> path;
         bool ate_separator = false;
+        // Set if reading from a block of memory, @ref stream then points into it.
+        std::unique_ptr<memory_source> memory;
 
         void skip_separator();
         void skip_pair_separator();
         void end_value();
+        // Append characters that need no decoding to the string, stop before anything else.
+        void read_plain_chars( std::string &s );
+        // Same as stream->get( ch ), without the overhead of the std::istream functions.
+        // At the end of the input `ch` is set to '\0', so a number may end the input.
+        void read_char( char &ch );
 
     public:
-        JsonIn( std::istream &s ) : stream( &s ) {}
-        JsonIn( std::istream &s, const std::string &path )
-            : stream( &s ), path( make_shared_fast<std::string>( path ) ) {}
-        JsonIn( std::istream &s, const json_source_location &loc )
-            : stream( &s ), path( loc.path ) {
-            seek( loc.offset );
-        }
+        JsonIn( std::istream &s );
+        JsonIn( std::istream &s, const std::string &path );
+        JsonIn( std::istream &s, const json_source_location &loc );
+        /**
+         * Read from a block of memory, which is much faster than reading from a file stream.
+         * The data is not copied: it must stay unchanged for as long as this object (and any
+         * JsonObject / JsonArray created from it) is in use.
+         */
+        JsonIn( const char *data, size_t size );
+        JsonIn( const char *data, size_t size, const std::string &path );
         JsonIn( const JsonIn & ) = delete;
         JsonIn &operator=( const JsonIn & ) = delete;
+        ~JsonIn();
 
         shared_ptr_fast<std::string> get_path() const {
             return path;
@@ -575,20 +589,34 @@ class JsonIn
  * Basic containers such as maps, sets and vectors,
  * as well as anything inheriting the JsonSerializer interface,
  * can be serialized automatically by write() and member().
+ *
+ * Output is collected in an internal buffer and handed to the stream
+ * whenever a top-level value is complete, when the buffer grows large,
+ * on flush() and on destruction. Anything that writes to the stream directly
+ * while a value is still open has to call flush() (or get_stream()) first.
  */
 class JsonOut
 {
     private:
         std::ostream *stream;
+        std::string buffer;
         bool pretty_print;
         std::vector<bool> need_wrap;
         int indent_level = 0;
         bool need_separator = false;
 
+        // Called after every complete value, flushes the buffer when appropriate.
+        void end_value();
+        void write_integer( long long val );
+        void write_integer( unsigned long long val );
+        void write_float( double val );
+        void write_float( long double val );
+
     public:
         JsonOut( std::ostream &stream, bool pretty_print = false, int depth = 0 );
         JsonOut( const JsonOut & ) = delete;
         JsonOut &operator=( const JsonOut & ) = delete;
+        ~JsonOut();
 
         // punctuation
         void write_indent();
@@ -601,8 +629,14 @@ class JsonOut
             need_separator = true;
         }
         std::ostream *get_stream() {
+            flush();
             return stream;
         }
+        // Hand everything written so far to the stream.
+        void flush();
+        // Line break that is written even without pretty printing,
+        // used to keep large compact files readable.
+        void write_newline();
         int tell();
         void seek( int pos );
         void start_pretty();
@@ -621,8 +655,18 @@ class JsonOut
             if( need_separator ) {
                 write_separator();
             }
-            *stream << val;
-            need_separator = true;
+            if( std::is_same<T, bool>::value ) {
+                buffer += val ? "true" : "false";
+            } else if( std::is_integral<T>::value && std::is_signed<T>::value ) {
+                write_integer( static_cast<long long>( val ) );
+            } else if( std::is_integral<T>::value ) {
+                write_integer( static_cast<unsigned long long>( val ) );
+            } else if( std::is_same<T, long double>::value ) {
+                write_float( static_cast<long double>( val ) );
+            } else {
+                write_float( static_cast<double>( val ) );
+            }
+            end_value();
         }
 
         /// Overload that calls a global function `serialize(const T&,JsonOut&)`, if available.
@@ -654,11 +698,11 @@ class JsonOut
                 write_separator();
             }
             if( val ) {
-                *stream << "true";
+                buffer += "true";
             } else {
-                *stream << "false";
+                buffer += "false";
             }
-            need_separator = true;
+            end_value();
         }
 
         // char should always be written as an unquoted numeral
@@ -1,9 +1,11 @@
 #include "lightmap.h" // IWYU pragma: associated
 #include "shadowcasting.h" // IWYU pragma: associated
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -34,6 +36,7 @@
 #include "point.h"
 #include "string_formatter.h"
 #include "submap.h"
+#include "thread_pool.h"
 #include "tileray.h"
 #include "type_id.h"
 #include "veh_type.h"
@@ -598,13 +601,7 @@ void map::generate_lightmap( const int zlev )
         unbuffered: (12^2)*(160*4) = apply_light_ray x 92160
         buffered:   (12*4)*(160)   = apply_light_ray x 7680
     */
-    const tripoint cache_start( 0, 0, zlev );
-    const tripoint cache_end( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y, zlev );
-    for( const tripoint &p : points_in_rectangle( cache_start, cache_end ) ) {
-        if( light_source_buffer[p.x][p.y] > 0.0 ) {
-            apply_light_source( p, light_source_buffer[p.x][p.y] );
-        }
-    }
+    apply_bulk_light_sources( zlev );
     for( const std::pair<tripoint, float> &elem : lm_override ) {
         lm[elem.first.x][elem.first.y].fill( elem.second );
     }
@@ -1072,47 +1069,79 @@ void cast_zlight(
     const array_of_grids_of < const diagonal_blocks > &blocked_caches,
     const tripoint &origin, const int offset_distance, const T numerator )
 {
-    // Down
-    cast_zlight_segment < 0, 1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, 1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    // Up
-    cast_zlight_segment<0, 1, 0, 1, 0, 0, 1, T, calc, check, accumulate>(
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment<1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate>(
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, 1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, 1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < 1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-
-    cast_zlight_segment < 0, -1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
-    cast_zlight_segment < -1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
-        output_caches, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+    const auto cast_down = [&]( const array_of_grids_of<T> & outputs ) {
+        cast_zlight_segment < 0, 1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < 1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, -1, 0, 1, 0, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < -1, 0, 0, 0, 1, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, 1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < 1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, -1, 0, -1, 0, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < -1, 0, 0, 0, -1, 0, -1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+    };
+    const auto cast_up = [&]( const array_of_grids_of<T> & outputs ) {
+        cast_zlight_segment<0, 1, 0, 1, 0, 0, 1, T, calc, check, accumulate>(
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment<1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate>(
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, -1, 0, 1, 0, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < -1, 0, 0, 0, 1, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, 1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < 1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+
+        cast_zlight_segment < 0, -1, 0, -1, 0, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+        cast_zlight_segment < -1, 0, 0, 0, -1, 0, 1, T, calc, check, accumulate > (
+            outputs, input_arrays, floor_caches, blocked_caches, origin, offset_distance, numerator );
+    };
+
+    if( thread_pool::concurrency() == 1 ) {
+        cast_down( output_caches );
+        cast_up( output_caches );
+        return;
+    }
+
+    // The two halves only share the origin level, so the upper one casts into a blank grid
+    // in its place which is merged in afterwards.  Cells are only ever raised to the max of what was cast into them, which
+    // makes the merged result the same as when both halves are cast one after another.
+    const int origin_index = origin.z + OVERMAP_DEPTH;
+    std::unique_ptr<T[][MAPSIZE_X][MAPSIZE_Y]> origin_level =
+        std::make_unique<T[][MAPSIZE_X][MAPSIZE_Y]>( 1 );
+    std::fill_n( &origin_level[0][0][0], MAPSIZE_X * MAPSIZE_Y, std::numeric_limits<T>::lowest() );
+    array_of_grids_of<T> up_caches = output_caches;
+    up_caches[origin_index] = origin_level.get();
+
+    thread_pool::run( 2, [&]( size_t half ) {
+        if( half == 0 ) {
+            cast_down( output_caches );
+        } else {
+            cast_up( up_caches );
+        }
+    } );
+
+    T( &origin_cache )[MAPSIZE_X][MAPSIZE_Y] = *output_caches[origin_index];
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        for( int y = 0; y < MAPSIZE_Y; y++ ) {
+            origin_cache[x][y] = std::max( origin_cache[x][y], origin_level[0][x][y] );
+        }
+    }
 }
 
 // I can't figure out how to make implicit instantiation work when the parameters of
@@ -1134,6 +1163,44 @@ cast_zlight<float, shrapnel_calc, shrapnel_check, accumulate_fragment_cloud>
     const array_of_grids_of < const diagonal_blocks > &blocked_caches,
     const tripoint &origin, int offset_distance, float numerator );
 
+namespace
+{
+
+/**
+ * Values castLight needs for every square it visits that only depend on the square's
+ * position relative to the origin, indexed by [row][-column] in octant space.
+ * Computed once with the same expressions castLight used to evaluate per square.
+ */
+struct octant_geometry {
+    static constexpr int max_row = 60;
+
+    float trailing_edge[max_row + 1][max_row + 1];
+    float leading_edge[max_row + 1][max_row + 1];
+    // rl_dist() from the origin with trigdist off and on
+    int square_distance[max_row + 1][max_row + 1];
+    int trig_distance[max_row + 1][max_row + 1];
+
+    octant_geometry() {
+        for( int row = 0; row <= max_row; ++row ) {
+            for( int column = 0; column <= max_row; ++column ) {
+                const tripoint delta( -column, -row, 0 );
+                trailing_edge[row][column] = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
+                leading_edge[row][column] = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+                square_distance[row][column] = square_dist( tripoint_zero, delta );
+                trig_distance[row][column] = trig_dist( tripoint_zero, delta );
+            }
+        }
+    }
+};
+
+const octant_geometry &get_octant_geometry()
+{
+    static const octant_geometry geometry;
+    return geometry;
+}
+
+} // namespace
+
 template<int xx, int xy, int yx, int yy, typename T, typename Out,
          T( *calc )( const T &, const T &, const int & ),
          bool( *check )( const T &, const T & ),
@@ -1183,12 +1250,19 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
     if( start < end ) {
         return;
     }
+    const octant_geometry &geometry = get_octant_geometry();
     T last_intensity = 0.0;
     tripoint delta;
     for( int distance = row; distance <= radius; distance++ ) {
         delta.y = -distance;
         bool started_row = false;
         T current_transparency = 0.0;
+        const float *const trailing_edges = geometry.trailing_edge[distance];
+        const float *const leading_edges = geometry.leading_edge[distance];
+        const int *const distances = trigdist ? geometry.trig_distance[distance] :
+                                     geometry.square_distance[distance];
+        // Squares of a row share cumulative_transparency, so intensity only changes with distance
+        int last_dist = -1;
         float away = start - ( -distance + 0.5f ) / ( -distance -
                      0.5f ); //The distance between our first leadingEdge and start
 
@@ -1197,8 +1271,8 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
 
         for( ; delta.x <= 0; delta.x++ ) {
             point current( offset.x + delta.x * xx + delta.y * xy, offset.y + delta.x * yx + delta.y * yy );
-            float trailingEdge = ( delta.x - 0.5f ) / ( delta.y + 0.5f );
-            float leadingEdge = ( delta.x + 0.5f ) / ( delta.y - 0.5f );
+            const float trailingEdge = trailing_edges[-delta.x];
+            const float leadingEdge = leading_edges[-delta.x];
 
             if( !( current.x >= 0 && current.y >= 0 && current.x < MAPSIZE_X &&
                    current.y < MAPSIZE_Y ) /* || start < leadingEdge */ ) {
@@ -1215,8 +1289,11 @@ void castLight( Out( &output_cache )[MAPSIZE_X][MAPSIZE_Y],
                 current_transparency = input_array[ current.x ][ current.y ];
             }
 
-            const int dist = rl_dist( tripoint_zero, delta ) + offsetDistance;
-            last_intensity = calc( numerator, cumulative_transparency, dist );
+            const int dist = distances[-delta.x] + offsetDistance;
+            if( dist != last_dist ) {
+                last_intensity = calc( numerator, cumulative_transparency, dist );
+                last_dist = dist;
+            }
 
             T new_transparency = input_array[ current.x ][ current.y ];
 
@@ -1510,6 +1587,19 @@ void map::build_seen_cache( const tripoint &origin, const int target_z )
     }
 }
 
+// Same pass as the seen cache, cast from a target instead of the player
+std::unique_ptr<visibility_field> map::build_visibility_field( const tripoint &origin ) const
+{
+    const level_cache &map_cache = get_cache_ref( origin.z );
+    std::unique_ptr<visibility_field> field = std::make_unique<visibility_field>();
+    std::fill_n( &field->seen[0][0], MAPSIZE_X * MAPSIZE_Y,
+                 static_cast<float>( LIGHT_TRANSPARENCY_SOLID ) );
+    field->seen[origin.x][origin.y] = VISIBILITY_FULL;
+    castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+        field->seen, map_cache.transparency_cache, map_cache.vehicle_obscured_cache, origin.xy(), 0 );
+    return field;
+}
+
 //Schraudolph's algorithm with John's constants
 static inline
 float fastexp( float x )
@@ -1543,8 +1633,14 @@ static bool light_check( const float &transparency, const float &intensity )
 void map::apply_light_source( const tripoint &p, float luminance )
 {
     auto &cache = get_cache( p.z );
-    four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y] = cache.lm;
-    float ( &sm )[MAPSIZE_X][MAPSIZE_Y] = cache.sm;
+    apply_light_source( p, luminance, cache.lm, cache.sm );
+}
+
+void map::apply_light_source( const tripoint &p, float luminance,
+                              four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                              float ( &sm )[MAPSIZE_X][MAPSIZE_Y] )
+{
+    auto &cache = get_cache( p.z );
     float ( &transparency_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.transparency_cache;
     float ( &light_source_buffer )[MAPSIZE_X][MAPSIZE_Y] = cache.light_source_buffer;
     diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = cache.vehicle_obscured_cache;
@@ -1621,6 +1717,288 @@ void map::apply_light_source( const tripoint &p, float luminance )
     }
 }
 
+namespace
+{
+
+/**
+ * Summed-area table over flags of the lightmap cells, answers whether any cell
+ * of a rectangle is flagged in constant time.
+ */
+class flagged_cells
+{
+    public:
+        template<typename Flag>
+        explicit flagged_cells( Flag flagged ) : sums( ( LIGHTMAP_CACHE_X + 1 ) * ( LIGHTMAP_CACHE_Y + 1 ) ) {
+            for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+                for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                    at( x + 1, y + 1 ) = ( flagged( x, y ) ? 1 : 0 ) + at( x, y + 1 ) + at( x + 1, y ) - at( x, y );
+                }
+            }
+        }
+
+        bool none() const {
+            return at( LIGHTMAP_CACHE_X, LIGHTMAP_CACHE_Y ) == 0;
+        }
+
+        // Any flagged cell within Chebyshev distance `radius` of p?
+        bool any_around( const point &p, int radius ) const {
+            const int x0 = std::max( p.x - radius, 0 );
+            const int y0 = std::max( p.y - radius, 0 );
+            const int x1 = std::min( p.x + radius + 1, LIGHTMAP_CACHE_X );
+            const int y1 = std::min( p.y + radius + 1, LIGHTMAP_CACHE_Y );
+            return at( x1, y1 ) - at( x0, y1 ) - at( x1, y0 ) + at( x0, y0 ) > 0;
+        }
+
+    private:
+        std::vector<int> sums;
+
+        int &at( int x, int y ) {
+            return sums[x * ( LIGHTMAP_CACHE_Y + 1 ) + y];
+        }
+        int at( int x, int y ) const {
+            return sums[x * ( LIGHTMAP_CACHE_Y + 1 ) + y];
+        }
+};
+
+} // namespace
+
+// Radius of the square around a bulk light source that apply_light_source reads or writes.
+// castLight stops after the first row whose intensity is at most LIGHT_AMBIENT_LOW, and the
+// cumulative transparency it computes intensity from never drops below the smallest
+// transparency of a tile light passes through. A row skipped entirely because of diagonal
+// vehicle walls doesn't stop it, so sources near those use the full cast radius instead.
+static int bulk_light_reach( float luminance, const point &p, const float min_transparency,
+                             const flagged_cells &obscured )
+{
+    constexpr int max_reach = 61;
+    if( luminance <= lit_level::LOW ) {
+        return 0;
+    } else if( luminance <= lit_level::BRIGHT_ONLY ) {
+        luminance = 1.49f;
+    }
+    int rows = 1;
+    while( rows < 60 && light_calc( luminance, min_transparency, rows ) > LIGHT_AMBIENT_LOW ) {
+        rows++;
+    }
+    // One extra tile for the neighbours and the diagonal blocks castLight peeks at
+    const int reach = rows + 1;
+    return obscured.any_around( p, reach ) ? max_reach : reach;
+}
+
+static bool operator==( const diagonal_blocks &l, const diagonal_blocks &r )
+{
+    return l.nw == r.nw && l.ne == r.ne;
+}
+
+static void merge_bulk_lights( four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                               float ( &sm )[MAPSIZE_X][MAPSIZE_Y], const bulk_light_cache::cast_data &bulk )
+{
+    for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+        for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+            lm[x][y] = elementwise_max( lm[x][y], bulk.lm[x][y] );
+            sm[x][y] = std::max( sm[x][y], bulk.sm[x][y] );
+        }
+    }
+}
+
+// Casts the sources into the bulk cache.  With more than one thread, they are split into
+// chunks and every chunk but the first is cast into a layer of its own, which is merged
+// into the cache afterwards.  Light is combined with max(), so the result is the same.
+void map::cast_bulk_light_sources( const std::vector<std::pair<tripoint, float>> &sources,
+                                   bulk_light_cache::cast_data &bulk )
+{
+    struct light_layer {
+        four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+        float sm[MAPSIZE_X][MAPSIZE_Y];
+    };
+    // Merging a layer costs about as much as casting a few dozen lights
+    constexpr size_t min_chunk_size = 32;
+    const size_t chunks = std::min<size_t>( thread_pool::concurrency(),
+                                            sources.size() / min_chunk_size );
+    if( chunks <= 1 ) {
+        for( const std::pair<tripoint, float> &source : sources ) {
+            apply_light_source( source.first, source.second, bulk.lm, bulk.sm );
+        }
+        return;
+    }
+
+    std::vector<std::unique_ptr<light_layer>> layers( chunks - 1 );
+    thread_pool::run( chunks, [&]( size_t chunk ) {
+        four_quadrants( *lm )[MAPSIZE_X][MAPSIZE_Y] = &bulk.lm;
+        float ( *sm )[MAPSIZE_X][MAPSIZE_Y] = &bulk.sm;
+        if( chunk > 0 ) {
+            layers[chunk - 1] = std::make_unique<light_layer>();
+            light_layer &layer = *layers[chunk - 1];
+            std::fill_n( &layer.lm[0][0], MAPSIZE_X * MAPSIZE_Y, four_quadrants( 0.0f ) );
+            std::fill_n( &layer.sm[0][0], MAPSIZE_X * MAPSIZE_Y, 0.0f );
+            lm = &layer.lm;
+            sm = &layer.sm;
+        }
+        const size_t begin = sources.size() * chunk / chunks;
+        const size_t end = sources.size() * ( chunk + 1 ) / chunks;
+        for( size_t i = begin; i < end; ++i ) {
+            apply_light_source( sources[i].first, sources[i].second, *lm, *sm );
+        }
+    } );
+    for( const std::unique_ptr<light_layer> &layer : layers ) {
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                bulk.lm[x][y] = elementwise_max( bulk.lm[x][y], layer->lm[x][y] );
+                bulk.sm[x][y] = std::max( bulk.sm[x][y], layer->sm[x][y] );
+            }
+        }
+    }
+}
+
+/*
+ * The contribution of the bulk light sources is a function of light_source_buffer,
+ * transparency_cache and vehicle_obscured_cache only, and is combined into the lightmap
+ * with max(), so it is kept between turns in bulk_light_cache. A source has to be cast
+ * again only if one of those inputs changed within its reach. The tiles any such source
+ * lit before or lights now are cleared, and every source reaching them is cast again;
+ * outside of them a clean source just rewrites what it wrote last time.
+ */
+void map::apply_bulk_light_sources( const int zlev )
+{
+    level_cache &map_cache = get_cache( zlev );
+    bulk_light_cache &cache = map_cache.bulk_lights;
+    const auto &light_source_buffer = map_cache.light_source_buffer;
+    const auto &transparency_cache = map_cache.transparency_cache;
+    const auto &obscured_cache = map_cache.vehicle_obscured_cache;
+    auto &lm = map_cache.lm;
+    auto &sm = map_cache.sm;
+    constexpr int cache_size = LIGHTMAP_CACHE_X * LIGHTMAP_CACHE_Y;
+    constexpr int stride = LIGHTMAP_CACHE_Y + 1;
+
+    if( !cache.data ) {
+        const float *const buffer = &light_source_buffer[0][0];
+        const auto is_lit = []( const float luminance ) {
+            return luminance > 0.0f;
+        };
+        if( std::none_of( buffer, buffer + cache_size, is_lit ) ) {
+            cache.sources_cast = 0;
+            return;
+        }
+        cache.data = cata::make_value<bulk_light_cache::cast_data>();
+        cache.valid = false;
+    }
+    bulk_light_cache::cast_data &bulk = *cache.data;
+
+    std::vector<std::pair<tripoint, float>> sources;
+    if( !cache.valid || cache.trigdist != trigdist ) {
+        std::fill_n( &bulk.lm[0][0], cache_size, four_quadrants( 0.0f ) );
+        std::fill_n( &bulk.sm[0][0], cache_size, 0.0f );
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                if( light_source_buffer[x][y] > 0.0f ) {
+                    sources.emplace_back( tripoint( x, y, zlev ), light_source_buffer[x][y] );
+                }
+            }
+        }
+    } else {
+        const flagged_cells changed( [&]( int x, int y ) {
+            return light_source_buffer[x][y] != bulk.light_source_buffer[x][y] ||
+                   transparency_cache[x][y] != bulk.transparency_cache[x][y] ||
+                   !( obscured_cache[x][y] == bulk.vehicle_obscured_cache[x][y] );
+        } );
+        if( changed.none() ) {
+            cache.sources_cast = 0;
+            merge_bulk_lights( lm, sm, bulk );
+            return;
+        }
+
+        // Old and new inputs together, whichever gives the larger reach
+        float min_transparency = LIGHT_TRANSPARENCY_OPEN_AIR;
+        const auto note_transparency = [&min_transparency]( const float transparency ) {
+            if( transparency > LIGHT_TRANSPARENCY_SOLID ) {
+                min_transparency = std::min( min_transparency, transparency );
+            }
+        };
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                note_transparency( transparency_cache[x][y] );
+                note_transparency( bulk.transparency_cache[x][y] );
+            }
+        }
+        // Less a bit for rounding in the running average castLight keeps
+        min_transparency *= 0.99f;
+        const flagged_cells obscured( [&]( int x, int y ) {
+            return obscured_cache[x][y].nw || obscured_cache[x][y].ne ||
+                   bulk.vehicle_obscured_cache[x][y].nw || bulk.vehicle_obscured_cache[x][y].ne;
+        } );
+
+        // Squares lit by sources that have to be cast again, old ones and new ones,
+        // summed up from a 2D difference array
+        std::vector<int> stale( ( LIGHTMAP_CACHE_X + 1 ) * stride );
+        const auto mark_stale = [&]( const float( &buffer )[MAPSIZE_X][MAPSIZE_Y] ) {
+            for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+                for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                    if( buffer[x][y] <= 0.0f ) {
+                        continue;
+                    }
+                    const int reach = bulk_light_reach( buffer[x][y], point( x, y ), min_transparency, obscured );
+                    if( !changed.any_around( point( x, y ), reach ) ) {
+                        continue;
+                    }
+                    const int x0 = std::max( x - reach, 0 );
+                    const int y0 = std::max( y - reach, 0 );
+                    const int x1 = std::min( x + reach + 1, LIGHTMAP_CACHE_X );
+                    const int y1 = std::min( y + reach + 1, LIGHTMAP_CACHE_Y );
+                    stale[x0 * stride + y0]++;
+                    stale[x1 * stride + y0]--;
+                    stale[x0 * stride + y1]--;
+                    stale[x1 * stride + y1]++;
+                }
+            }
+        };
+        mark_stale( bulk.light_source_buffer );
+        mark_stale( light_source_buffer );
+        for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+            for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                int &cur = stale[x * stride + y];
+                if( x > 0 ) {
+                    cur += stale[( x - 1 ) * stride + y];
+                }
+                if( y > 0 ) {
+                    cur += stale[x * stride + y - 1];
+                }
+                if( x > 0 && y > 0 ) {
+                    cur -= stale[( x - 1 ) * stride + y - 1];
+                }
+                if( cur > 0 ) {
+                    bulk.lm[x][y].fill( 0.0f );
+                    bulk.sm[x][y] = 0.0f;
+                }
+            }
+        }
+
+        const flagged_cells cleared( [&]( int x, int y ) {
+            return stale[x * stride + y] > 0;
+        } );
+        if( !cleared.none() ) {
+            for( int x = 0; x < LIGHTMAP_CACHE_X; ++x ) {
+                for( int y = 0; y < LIGHTMAP_CACHE_Y; ++y ) {
+                    const float luminance = light_source_buffer[x][y];
+                    if( luminance > 0.0f &&
+                        cleared.any_around( point( x, y ),
+                                            bulk_light_reach( luminance, point( x, y ), min_transparency, obscured ) ) ) {
+                        sources.emplace_back( tripoint( x, y, zlev ), luminance );
+                    }
+                }
+            }
+        }
+    }
+    cast_bulk_light_sources( sources, bulk );
+    cache.sources_cast = static_cast<int>( sources.size() );
+
+    std::copy_n( &light_source_buffer[0][0], cache_size, &bulk.light_source_buffer[0][0] );
+    std::copy_n( &transparency_cache[0][0], cache_size, &bulk.transparency_cache[0][0] );
+    std::copy_n( &obscured_cache[0][0], cache_size, &bulk.vehicle_obscured_cache[0][0] );
+    cache.valid = true;
+    cache.trigdist = trigdist;
+    merge_bulk_lights( lm, sm, bulk );
+}
+
 void map::apply_directional_light( const tripoint &p, int direction, float luminance )
 {
     const point p2( p.xy() );
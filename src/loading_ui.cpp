@@ -1,13 +1,16 @@
 #include "loading_ui.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
 #include "cached_options.h"
 #include "color.h"
+#include "debug.h"
 #include "input.h"
 #include "output.h"
 #include "sdl_wrappers.h"
+#include "string_formatter.h"
 #include "translations.h"
 #include "ui.h"
 #include "ui_manager.h"
@@ -20,17 +23,30 @@ loading_ui::loading_ui( bool display )
     }
 }
 
-loading_ui::~loading_ui() = default;
+loading_ui::~loading_ui()
+{
+    report_times();
+}
 
 void loading_ui::add_entry( const std::string &description )
 {
+    entry_names.push_back( description );
     if( menu != nullptr ) {
         menu->addentry( menu->entries.size(), true, 0, description );
+        if( profile_startup ) {
+            // Reserve the column for the time, the menu is not resized later on.
+            menu->entries.back().ctxt = "        ";
+        }
     }
 }
 
 void loading_ui::new_context( const std::string &desc )
 {
+    report_times();
+    context = desc;
+    entry_names.clear();
+    entry_times.clear();
+    entry_started = false;
     if( menu != nullptr ) {
         menu->reset();
         menu->settext( desc );
@@ -55,10 +71,48 @@ void loading_ui::init()
     }
 }
 
+void loading_ui::report_times()
+{
+    if( !profile_startup || entry_times.empty() ) {
+        return;
+    }
+    std::chrono::milliseconds total( 0 );
+    for( const auto &e : entry_times ) {
+        total += e.second;
+    }
+    std::stable_sort( entry_times.begin(), entry_times.end(),
+    []( const std::pair<std::string, std::chrono::milliseconds> &a,
+    const std::pair<std::string, std::chrono::milliseconds> &b ) {
+        return a.second > b.second;
+    } );
+    std::string report = string_format( "Startup profile for \"%s\": %d ms total", context,
+                                        total.count() );
+    for( const auto &e : entry_times ) {
+        report += string_format( "\n%8d ms  %s", e.second.count(), e.first );
+    }
+    DebugLog( DL::Info, DC::Main ) << report;
+    entry_times.clear();
+}
+
 void loading_ui::proceed()
 {
     init();
 
+    if( profile_startup ) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const size_t index = entry_times.size();
+        if( entry_started && index < entry_names.size() ) {
+            const std::chrono::milliseconds elapsed =
+                std::chrono::duration_cast<std::chrono::milliseconds>( now - entry_start );
+            entry_times.emplace_back( entry_names[index], elapsed );
+            if( menu != nullptr && index < menu->entries.size() ) {
+                menu->entries[index].ctxt = string_format( "%d ms", elapsed.count() );
+            }
+        }
+        entry_start = now;
+        entry_started = true;
+    }
+
     if( menu != nullptr && !menu->entries.empty() ) {
         if( menu->selected >= 0 && menu->selected < static_cast<int>( menu->entries.size() ) ) {
             // TODO: Color it red if it errored hard, yellow on warnings
@@ -77,6 +131,11 @@ void loading_ui::show()
 {
     init();
 
+    if( profile_startup && !entry_started ) {
+        entry_start = std::chrono::steady_clock::now();
+        entry_started = true;
+    }
+
     if( menu != nullptr ) {
         ui_manager::redraw();
         refresh_display();
@@ -2,8 +2,11 @@
 #ifndef CATA_SRC_LOADING_UI_H
 #define CATA_SRC_LOADING_UI_H
 
+#include <chrono>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 class background_pane;
 class ui_adaptor;
@@ -16,7 +19,15 @@ class loading_ui
         std::unique_ptr<ui_adaptor> ui;
         std::unique_ptr<background_pane> ui_background;
 
+        // Timing of the entries in the current context, only kept with @ref profile_startup.
+        std::string context;
+        std::vector<std::string> entry_names;
+        std::vector<std::pair<std::string, std::chrono::milliseconds>> entry_times;
+        std::chrono::steady_clock::time_point entry_start;
+        bool entry_started = false;
+
         void init();
+        void report_times();
     public:
         loading_ui( bool display );
         ~loading_ui();
@@ -32,6 +43,8 @@ class loading_ui
         /**
          * Place the UI onto UI stack, mark current entry as processed, scroll down,
          * and redraw. (if display is enabled)
+         * The time since the previous entry was finished (or since the first call to
+         * show()) is recorded as the duration of the entry.
          */
         void proceed();
         /**
@@ -239,7 +239,7 @@ int main( int argc, char *argv[] )
         const char *section_default = nullptr;
         const char *section_map_sharing = "Map sharing";
         const char *section_user_directory = "User directories";
-        const std::array<arg_handler, 16> first_pass_arguments = {{
+        const std::array<arg_handler, 17> first_pass_arguments = {{
                 {
                     "--seed", "<string of letters and or numbers>",
                     "Sets the random number generator's seed value",
@@ -418,6 +418,15 @@ int main( int argc, char *argv[] )
                         return 0;
                     }
                 },
+                {
+                    "--profile-startup", nullptr,
+                    "Reports how long each step of loading the game data takes",
+                    section_default,
+                    []( int, const char ** ) -> int {
+                        profile_startup = true;
+                        return 0;
+                    }
+                },
                 {
                     "--editor", nullptr,
                     "If set, will enter Advanced Map Editor on first world load",
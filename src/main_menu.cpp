@@ -27,7 +27,6 @@
 #include "get_version.h"
 #include "help.h"
 #include "ime.h"
-#include "loading_ui.h"
 #include "mapbuffer.h"
 #include "mapsharing.h"
 #include "newcharacter.h"
@@ -395,8 +394,7 @@ void main_menu::init_strings()
         vSettingsHotkeys.push_back( get_hotkeys( item ) );
     }
 
-    loading_ui ui( false );
-    g->load_core_data( ui );
+    g->load_core_data();
     vdaytip = SNIPPET.random_from_category( "tip" ).value_or( translation() ).translated();
 }
 
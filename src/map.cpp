@@ -1416,7 +1416,7 @@ void map::furn_set( const tripoint &p, const furn_id &new_furniture,
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     // Make sure the furniture falls if it needs to
     support_dirty( p );
@@ -1697,7 +1697,7 @@ bool map::ter_set( const tripoint &p, const ter_id &new_terrain )
     set_memory_seen_cache_dirty( p );
 
     // TODO: Limit to changes that affect move cost, traps and stairs
-    set_pathfinding_cache_dirty( p.z );
+    set_pathfinding_cache_dirty( p );
 
     tripoint above( p.xy(), p.z + 1 );
     // Make sure that if we supported something and no longer do so, it falls down
@@ -5451,7 +5451,7 @@ bool map::add_field( const tripoint &p, const field_type_id &type_id, int intens
     }
 
     if( fd_type.is_dangerous() ) {
-        set_pathfinding_cache_dirty( p.z );
+        set_pathfinding_cache_dirty( p );
     }
 
     // Ensure blood type fields don't hang in the air
@@ -5483,7 +5483,7 @@ void map::remove_field( const tripoint &p, const field_type_id &field_to_remove
             set_seen_cache_dirty( p );
         }
         if( fdata.is_dangerous() ) {
-            set_pathfinding_cache_dirty( p.z );
+            set_pathfinding_cache_dirty( p );
         }
     }
 }
@@ -6141,10 +6141,59 @@ void map::draw_from_above( const catacurses::window &w, const tripoint &p,
 
 bool map::sees( const tripoint &F, const tripoint &T, const int range ) const
 {
+    if( target_sight_checks && !visibility_fields.empty() && F.z == T.z ) {
+        const auto field = visibility_fields.find( T );
+        if( field != visibility_fields.end() ) {
+            if( ( range >= 0 && range < rl_dist( F, T ) ) || !inbounds( F ) ) {
+                return false;
+            }
+            if( !field->second ) {
+                field->second = build_visibility_field( T );
+            }
+            return field->second->seen[F.x][F.y] > LIGHT_TRANSPARENCY_SOLID;
+        }
+    }
     int dummy = 0;
     return sees( F, T, range, dummy );
 }
 
+void map::add_visibility_target( const tripoint &T )
+{
+    if( inbounds( T ) ) {
+        visibility_fields.emplace( T, nullptr );
+    }
+}
+
+void map::clear_visibility_targets()
+{
+    visibility_fields.clear();
+}
+
+void map::begin_target_sight_checks() const
+{
+    target_sight_checks = true;
+}
+
+void map::end_target_sight_checks() const
+{
+    target_sight_checks = false;
+}
+
+void map::begin_parallel_sight_checks() const
+{
+    for( auto &field : visibility_fields ) {
+        if( !field.second ) {
+            field.second = build_visibility_field( field.first );
+        }
+    }
+    parallel_sight_checks = true;
+}
+
+void map::end_parallel_sight_checks() const
+{
+    parallel_sight_checks = false;
+}
+
 /**
  * This one is internal-only, we don't want to expose the slope tweaking ickiness outside the map class.
  **/
@@ -6164,7 +6213,10 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         min.x << 16 | min.y << 8 | ( min.z + OVERMAP_DEPTH ),
         max.x << 16 | max.y << 8 | ( max.z + OVERMAP_DEPTH )
     );
-    char cached = skew_vision_cache.get( key, -1 );
+    // The cache is shared by both directions of a line, so what it holds depends on the order
+    // lines were traced in. It's left alone while other threads could be tracing too.
+    const bool use_cache = !parallel_sight_checks;
+    const char cached = use_cache ? skew_vision_cache.get( key, -1 ) : -1;
     if( cached >= 0 ) {
         return cached > 0;
     }
@@ -6189,7 +6241,9 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
             last_point = new_point;
             return true;
         } );
-        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        if( use_cache ) {
+            skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+        }
         return visible;
     }
 
@@ -6222,7 +6276,9 @@ bool map::sees( const tripoint &F, const tripoint &T, const int range,
         last_point = new_point;
         return true;
     } );
-    skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    if( use_cache ) {
+        skew_vision_cache.insert( 100000, key, visible ? 1 : 0 );
+    }
     return visible;
 }
 
@@ -8230,11 +8286,12 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     const int minz = zlevels ? -OVERMAP_DEPTH : zlev;
     const int maxz = zlevels ? OVERMAP_HEIGHT : zlev;
     bool seen_cache_dirty = false;
+    bool transparency_changed = false;
     for( int z = minz; z <= maxz; z++ ) {
         // trigger FOV recalculation only when there is a change on the player's level or if fov_3d is enabled
         const bool affects_seen_cache =  z == zlev || fov_3d;
         build_outside_cache( z );
-        build_transparency_cache( z );
+        transparency_changed |= build_transparency_cache( z );
         update_suspension_cache( z );
         seen_cache_dirty |= ( build_floor_cache( z ) && affects_seen_cache );
         seen_cache_dirty |= get_cache( z ).seen_cache_dirty && affects_seen_cache;
@@ -8255,6 +8312,11 @@ void map::build_map_cache( const int zlev, bool skip_lightmap )
     if( seen_cache_dirty ) {
         skew_vision_cache.clear();
     }
+    if( seen_cache_dirty || transparency_changed ) {
+        for( auto &field : visibility_fields ) {
+            field.second.reset();
+        }
+    }
     // Initial value is illegal player position.
     const tripoint &p = g->u.pos();
     static tripoint player_prev_pos;
@@ -8801,6 +8863,19 @@ void map::set_pathfinding_cache_dirty( const int zlev )
 {
     if( inbounds_z( zlev ) ) {
         get_pathfinding_cache( zlev ).dirty = true;
+        if( path_portals ) {
+            path_portals->invalidate( zlev );
+        }
+    }
+}
+
+void map::set_pathfinding_cache_dirty( const tripoint &p )
+{
+    if( inbounds_z( p.z ) ) {
+        get_pathfinding_cache( p.z ).dirty = true;
+        if( path_portals ) {
+            path_portals->invalidate( p );
+        }
     }
 }
 
@@ -8824,6 +8899,7 @@ void map::update_pathfinding_cache( int zlev ) const
     if( !cache.dirty ) {
         return;
     }
+    cache.generation++;
 
     std::uninitialized_fill_n( &cache.special[0][0], MAPSIZE_X * MAPSIZE_Y, PF_NORMAL );
 
@@ -36,6 +36,7 @@
 #include "shadowcasting.h"
 #include "type_id.h"
 #include "units.h"
+#include "value_ptr.h"
 
 struct scent_block;
 template <typename T> class string_id;
@@ -86,6 +87,9 @@ using VehicleList = std::vector<wrapped_vehicle>;
 class map;
 
 enum ter_bitflags : int;
+struct flow_field;
+class portal_graph;
+struct route_cache;
 struct pathfinding_cache;
 struct pathfinding_settings;
 template<typename T>
@@ -298,6 +302,39 @@ struct diagonal_blocks {
     bool ne;
 };
 
+/**
+ * Lightmap contribution of the bulk light sources (see map::add_light_source), together with
+ * the inputs it was cast from. Kept between calls to map::generate_lightmap so that only
+ * the sources whose surroundings changed since the last call have to be cast again.
+ */
+struct bulk_light_cache {
+    struct cast_data {
+        four_quadrants lm[MAPSIZE_X][MAPSIZE_Y];
+        float sm[MAPSIZE_X][MAPSIZE_Y];
+
+        float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+        float transparency_cache[MAPSIZE_X][MAPSIZE_Y];
+        diagonal_blocks vehicle_obscured_cache[MAPSIZE_X][MAPSIZE_Y];
+    };
+
+    // False until the first full cast, data is garbage until then
+    bool valid = false;
+    // Value of @ref trigdist the data was cast with, castLight measures distance with it
+    bool trigdist = false;
+    // Number of sources cast by the last call to map::generate_lightmap
+    int sources_cast = 0;
+    // About half a megabyte, only allocated once the z-level has bulk light sources
+    cata::value_ptr<cast_data> data;
+};
+
+/**
+ * What can be seen from a point on its z-level, in the same format as level_cache::seen_cache.
+ * See map::add_visibility_target.
+ */
+struct visibility_field {
+    float seen[MAPSIZE_X][MAPSIZE_Y];
+};
+
 struct level_cache {
     // Zeros all relevant values
     level_cache();
@@ -316,6 +353,8 @@ struct level_cache {
     // To prevent redundant ray casting into neighbors: precalculate bulk light source positions.
     // This is only valid for the duration of generate_lightmap
     float light_source_buffer[MAPSIZE_X][MAPSIZE_Y];
+    // Bulk light sources cast on previous turns, see bulk_light_cache
+    bulk_light_cache bulk_lights;
 
     // if false, means tile is under the roof ("inside"), true means tile is "outside"
     // "inside" tiles are protected from sun, rain, etc. (see "INDOORS" flag)
@@ -458,6 +497,7 @@ class map
         }
 
         void set_pathfinding_cache_dirty( int zlev );
+        void set_pathfinding_cache_dirty( const tripoint &p );
         /*@}*/
 
         void set_memory_seen_cache_dirty( const tripoint &p ) {
@@ -596,10 +636,13 @@ class map
         maptile maptile_at_internal( const tripoint &p );
         std::pair<tripoint, maptile> maptile_has_bounds( const tripoint &p, bool bounds_checked );
         std::array<std::pair<tripoint, maptile>, 8> get_neighbors( const tripoint &p );
+        // in_forest is @ref slows_wind for the overmap terrain, the same for the whole submap
         void spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
-                         const time_duration &outdoor_age_speedup, scent_block &sblk );
+                         const time_duration &outdoor_age_speedup, scent_block &sblk, bool in_forest );
         void create_hot_air( const tripoint &p, int intensity );
         bool gas_can_spread_to( field_entry &cur, const tripoint &src, const tripoint &dst );
+        bool gas_can_spread_to( field_entry &cur, const tripoint &src, const maptile &dst_tile,
+                                const tripoint &dst );
         void gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p );
         int burn_body_part( player &u, field_entry &cur, body_part bp, int scale );
     public:
@@ -672,6 +715,29 @@ class map
         * Returns whether `F` sees `T` with a view range of `range`.
         */
         bool sees( const tripoint &F, const tripoint &T, int range ) const;
+        /**
+         * Registers `T` for target sight checks, see begin_target_sight_checks().
+         * Pays off for targets many creatures look at, like NPCs in front of a horde.
+         * The field is built on first use and rebuilt after the transparency changed.
+         */
+        void add_visibility_target( const tripoint &T );
+        void clear_visibility_targets();
+        /**
+         * Between these two, sees() answers whether something on the same z-level sees a
+         * registered target by looking it up in a field shadowcast from the target once,
+         * instead of tracing a line for each viewer. Shadowcasting doesn't agree with the
+         * traced line on every tile, so only monsters rating their targets use this.
+         */
+        void begin_target_sight_checks() const;
+        void end_target_sight_checks() const;
+        /**
+         * Between these two, sees() may be called from several threads at once, as long as
+         * nothing changes the map. Visibility targets are all built up front, and lines of
+         * sight are traced without the skew vision cache, so answers don't depend on which
+         * lines were traced before.
+         */
+        void begin_parallel_sight_checks() const;
+        void end_parallel_sight_checks() const;
     private:
         /**
          * Don't expose the slope adjust outside map functions.
@@ -752,6 +818,9 @@ class map
         /**
          * Calculate the best path using A*
          *
+         * Long routes are planned on the @ref portal_graph first and then searched for
+         * one submap at a time, so they aren't limited to a box around both ends.
+         *
          * @param f The source location from which to path.
          * @param t The destination to which to path.
          * @param settings Structure describing pathfinding parameters.
@@ -760,6 +829,30 @@ class map
         std::vector<tripoint> route( const tripoint &f, const tripoint &t,
                                      const pathfinding_settings &settings,
         const std::set<tripoint> &pre_closed = {{ }} ) const;
+        /**
+         * Same as @ref route without pre-closed points, for destinations that many creatures
+         * head for at once, such as a horde chasing the player. Instead of a search per
+         * creature, one Dijkstra flow field is computed back from @p t over its z-level and
+         * shared by every creature with the same settings until the turn ends or the
+         * pathfinding cache changes. Not thread-safe.
+         * Routes between z-levels are handed to @ref route.
+         */
+        std::vector<tripoint> route_to_shared_target( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings ) const;
+        /**
+         * Checks whether @p path, made earlier by one of the above, still leads from @p f to
+         * @p t, and patches it up with short local searches where it doesn't: if @p t moved
+         * by a few tiles, if the map changed under it, or if one of @p pre_closed stands
+         * on its first few steps.
+         * Returns false if the path is beyond repair and has to be searched for again,
+         * after which @ref remember_route has to be called.
+         */
+        bool repair_route( std::vector<tripoint> &path, route_cache &cache, const tripoint &f,
+                           const tripoint &t, const pathfinding_settings &settings,
+                           const std::set<tripoint> &pre_closed ) const;
+        /** Fills @p cache for a @p path from @p f that was just searched for. */
+        void remember_route( const std::vector<tripoint> &path, route_cache &cache, const tripoint &f,
+                             const pathfinding_settings &settings ) const;
 
         // Vehicles: Common to 2D and 3D
         VehicleList get_vehicles();
@@ -1817,7 +1910,13 @@ class map
         void update_suspension_cache( const int &z );
     protected:
         void generate_lightmap( int zlev );
+        // Casts the sources in light_source_buffer, reusing what it can from bulk_light_cache
+        void apply_bulk_light_sources( int zlev );
+        // Casts the given sources and luminances into bulk_light_cache, spread over thread_pool
+        void cast_bulk_light_sources( const std::vector<std::pair<tripoint, float>> &sources,
+                                      bulk_light_cache::cast_data &bulk );
         void build_seen_cache( const tripoint &origin, int target_z );
+        std::unique_ptr<visibility_field> build_visibility_field( const tripoint &origin ) const;
         void apply_character_light( Character &p );
 
         //Adds/removes player specific transparencies
@@ -1937,6 +2036,10 @@ class map
         // ...this, which will apply the light after at the end of generate_lightmap, and prevent redundant
         // light rays from causing massive slowdowns, if there's a huge amount of light.
         void add_light_source( const tripoint &p, float luminance );
+        // apply_light_source, but into the given arrays instead of the lightmap of p's z-level.
+        void apply_light_source( const tripoint &p, float luminance,
+                                 four_quadrants( &lm )[MAPSIZE_X][MAPSIZE_Y],
+                                 float ( &sm )[MAPSIZE_X][MAPSIZE_Y] );
         // Handle just cardinal directions and 45 deg angles.
         void apply_directional_light( const tripoint &p, int direction, float luminance );
         void apply_light_arc( const tripoint &p, units::angle, float luminance,
@@ -2016,6 +2119,14 @@ class map
         std::array< std::unique_ptr<level_cache>, OVERMAP_LAYERS > caches;
 
         mutable std::array< std::unique_ptr<pathfinding_cache>, OVERMAP_LAYERS > pathfinding_caches;
+        /**
+         * Fields computed by route_to_shared_target, oldest first.
+         */
+        mutable std::vector<std::unique_ptr<flow_field>> flow_fields;
+        /**
+         * Plans long routes, null until first needed.
+         */
+        mutable std::unique_ptr<portal_graph> path_portals;
         /**
          * Set of submaps that contain active items in absolute coordinates.
          */
@@ -2025,6 +2136,12 @@ class map
          * Cache of coordinate pairs recently checked for visibility.
          */
         mutable lru_cache<point, char> skew_vision_cache;
+        mutable bool parallel_sight_checks = false;
+        mutable bool target_sight_checks = false;
+        /**
+         * Fields for the points passed to add_visibility_target, null until first needed.
+         */
+        mutable std::map<tripoint, std::unique_ptr<visibility_field>> visibility_fields;
 
         /**
          * Vehicle list doesn't change often, but is pretty expensive.
@@ -2039,6 +2156,24 @@ class map
 
         pathfinding_cache &get_pathfinding_cache( int zlev ) const;
 
+        /**
+         * Cost of stepping from @p from onto the adjacent @p to, or one of @ref pf_step if
+         * that's not possible. @p from_veh is the vehicle at @p from.
+         */
+        int pathfinding_step_cost( const tripoint &from, const tripoint &to,
+                                   const pathfinding_settings &settings, const pathfinding_cache &pf_cache,
+                                   const vehicle *from_veh ) const;
+        const flow_field &get_flow_field( const tripoint &t, const pathfinding_settings &settings ) const;
+        // Cost of following path from f, or a negative pf_step if a step of it is impossible
+        int route_cost( const std::vector<tripoint> &path, const tripoint &f,
+                        const pathfinding_settings &settings ) const;
+        // Parts of route: following the portal graph, and A* within a box around both ends
+        std::vector<tripoint> route_through_portals( const tripoint &f, const tripoint &t,
+                const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const;
+        std::vector<tripoint> route_locally( const tripoint &f, const tripoint &t,
+                                             const pathfinding_settings &settings,
+                                             const std::set<tripoint> &pre_closed ) const;
+
         visibility_variables visibility_variables_cache;
 
         // caches the highest zlevel above which all zlevels are uniform
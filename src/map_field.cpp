@@ -144,6 +144,9 @@ void map::process_fields()
     const int maxz = zlevels ? OVERMAP_HEIGHT : abs_sub.z;
     for( int z = minz; z <= maxz; z++ ) {
         auto &field_cache = get_cache( z ).field_cache;
+        if( field_cache.none() ) {
+            continue;
+        }
         for( int x = 0; x < my_MAPSIZE; x++ ) {
             for( int y = 0; y < my_MAPSIZE; y++ ) {
                 if( field_cache[ x + y * MAPSIZE ] ) {
@@ -210,7 +213,12 @@ std::array<std::pair<tripoint, maptile>, 8> map::get_neighbors( const tripoint &
 
 bool map::gas_can_spread_to( field_entry &cur, const tripoint &src, const tripoint &dst )
 {
-    maptile dst_tile = maptile_at( dst );
+    return gas_can_spread_to( cur, src, maptile_at( dst ), dst );
+}
+
+bool map::gas_can_spread_to( field_entry &cur, const tripoint &src, const maptile &dst_tile,
+                             const tripoint &dst )
+{
     const field_entry *tmpfld = dst_tile.get_field().find_field( cur.get_field_type() );
     // Candidates are existing weaker fields or navigable/flagged tiles with no field.
     if( tmpfld == nullptr || tmpfld->get_field_intensity() < cur.get_field_intensity() ) {
@@ -249,16 +257,13 @@ void map::gas_spread_to( field_entry &cur, maptile &dst, const tripoint &p )
 }
 
 void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
-                      const time_duration &outdoor_age_speedup, scent_block &sblk )
+                      const time_duration &outdoor_age_speedup, scent_block &sblk,
+                      const bool in_forest )
 {
-    map &here = get_map();
-    // TODO: fix point types
-    const oter_id &cur_om_ter =
-        overmap_buffer.ter( tripoint_abs_omt( ms_to_omt_copy( here.getabs( p ) ) ) );
     const bool sheltered = g->is_sheltered( p );
     const weather_manager &weather = get_weather();
     const int winddirection = weather.winddirection;
-    const int windpower = get_local_windpower( weather.windspeed, cur_om_ter, p, winddirection,
+    const int windpower = get_local_windpower( weather.windspeed, in_forest, p, winddirection,
                           sheltered );
 
     const int current_intensity = cur.get_field_intensity();
@@ -298,8 +303,11 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
 
     auto neighs = get_neighbors( p );
     size_t end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
-    std::vector<size_t> spread;
-    std::vector<size_t> neighbour_vec;
+    // Indices into neighs, there are never more than 8 of them
+    std::array<size_t, 8> spread;
+    size_t spread_count = 0;
+    std::array<size_t, 8> neighbour_vec;
+    size_t neighbour_count = 0;
     // Then, spread to a nearby point.
     // If not possible (or randomly), try to spread up
     // Wind direction will block the field spreading into the wind.
@@ -308,21 +316,21 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
          count != neighs.size();
          i = ( i + 1 ) % neighs.size(), count++ ) {
         const auto &neigh = neighs[i];
-        if( gas_can_spread_to( cur, p, neigh.first ) ) {
-            spread.push_back( i );
+        if( gas_can_spread_to( cur, p, neigh.second, neigh.first ) ) {
+            spread[spread_count++] = i;
         }
     }
-    auto maptiles = get_wind_blockers( winddirection, p );
-    // Three map tiles that are facing the wind direction.
-    const maptile remove_tile = std::get<0>( maptiles );
-    const maptile remove_tile2 = std::get<1>( maptiles );
-    const maptile remove_tile3 = std::get<2>( maptiles );
-    if( !spread.empty() && ( !zlevels || one_in( spread.size() ) ) ) {
+    if( spread_count > 0 && ( !zlevels || one_in( spread_count ) ) ) {
         // Construct the destination from offset and p
-        if( g->is_sheltered( p ) || windpower < 5 ) {
-            std::pair<tripoint, maptile> &n = neighs[ random_entry( spread ) ];
+        if( sheltered || windpower < 5 ) {
+            std::pair<tripoint, maptile> &n = neighs[ spread[rng( 0, spread_count - 1 )] ];
             gas_spread_to( cur, n.second, n.first );
         } else {
+            auto maptiles = get_wind_blockers( winddirection, p );
+            // Three map tiles that are facing the wind direction.
+            const maptile remove_tile = std::get<0>( maptiles );
+            const maptile remove_tile2 = std::get<1>( maptiles );
+            const maptile remove_tile3 = std::get<2>( maptiles );
             end_it = static_cast<size_t>( rng( 0, neighs.size() - 1 ) );
             // Start at end_it + 1, then wrap around until all elements have been processed.
             for( size_t i = ( end_it + 1 ) % neighs.size(), count = 0;
@@ -332,13 +340,13 @@ void map::spread_gas( field_entry &cur, const tripoint &p, int percent_spread,
                 if( ( neigh.pos_.x != remove_tile.pos_.x && neigh.pos_.y != remove_tile.pos_.y ) ||
                     ( neigh.pos_.x != remove_tile2.pos_.x && neigh.pos_.y != remove_tile2.pos_.y ) ||
                     ( neigh.pos_.x != remove_tile3.pos_.x && neigh.pos_.y != remove_tile3.pos_.y ) ) {
-                    neighbour_vec.push_back( i );
+                    neighbour_vec[neighbour_count++] = i;
                 } else if( x_in_y( 1, std::max( 2, windpower ) ) ) {
-                    neighbour_vec.push_back( i );
+                    neighbour_vec[neighbour_count++] = i;
                 }
             }
-            if( !neighbour_vec.empty() ) {
-                std::pair<tripoint, maptile> &n = neighs[neighbour_vec[rng( 0, neighbour_vec.size() - 1 )]];
+            if( neighbour_count > 0 ) {
+                std::pair<tripoint, maptile> &n = neighs[neighbour_vec[rng( 0, neighbour_count - 1 )]];
                 gas_spread_to( cur, n.second, n.first );
             }
         }
@@ -397,6 +405,10 @@ void map::process_fields_in_submap( submap *const current_submap,
                                     const tripoint &submap )
 {
     scent_block sblk( submap, g->scent );
+    // A submap never straddles two overmap terrains, so this holds for all of its tiles
+    // TODO: fix point types
+    const tripoint_abs_omt omt( sm_to_omt_copy( tripoint( abs_sub.xy(), 0 ) + submap ) );
+    const bool in_forest = slows_wind( overmap_buffer.ter( omt ) );
 
     // Holds m.field_at(x,y).find_field(fd_some_field) type returns.
     // Just to avoid typing that long string for a temp value.
@@ -850,7 +862,7 @@ void map::process_fields_in_submap( submap *const current_submap,
                     const int gas_percent_spread = cur_fd_type.percent_spread;
                     if( gas_percent_spread > 0 ) {
                         const time_duration outdoor_age_speedup = cur_fd_type.outdoor_age_speedup;
-                        spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk );
+                        spread_gas( cur, p, gas_percent_spread, outdoor_age_speedup, sblk, in_forest );
                     }
                 }
 
@@ -1142,7 +1154,7 @@ void map::process_fields_in_submap( submap *const current_submap,
                                 }
                             }
                         } else {
-                            spread_gas( cur, p, 5, 0_turns, sblk );
+                            spread_gas( cur, p, 5, 0_turns, sblk, in_forest );
                         }
                     }
                 }
@@ -10,11 +10,13 @@
 #include <list>
 #include <memory>
 #include <ostream>
+#include <set>
 #include <unordered_map>
 
 #include "avatar.h"
 #include "behavior.h"
 #include "bionics.h"
+#include "cached_options.h"
 #include "cata_utility.h"
 #include "creature_tracker.h"
 #include "debug.h"
@@ -48,6 +50,7 @@
 #include "vehicle.h"
 #include "vpart_position.h"
 
+static const efftype_id effect_ai_controlled( "ai_controlled" );
 static const efftype_id effect_ai_waiting( "ai_waiting" );
 static const efftype_id effect_bouldering( "bouldering" );
 static const efftype_id effect_countdown( "countdown" );
@@ -291,7 +294,7 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
         return FLT_MAX;
     }
 
-    if( !sees( c ) ) {
+    if( !sees_planned( c ) ) {
         return FLT_MAX;
     }
 
@@ -313,6 +316,87 @@ float monster::rate_target( Creature &c, float best, bool smart ) const
     return FLT_MAX;
 }
 
+std::vector<Creature *> monster::sight_candidates() const
+{
+    std::vector<Creature *> ret;
+    if( has_effect( effect_ai_controlled ) || has_effect( effect_ai_waiting ) ||
+        ( friendly != 0 && has_effect( effect_docile ) ) ) {
+        return ret;
+    }
+    // Further away than this, plan rejects targets before looking for them
+    const int range = has_flag( MF_PRIORITIZE_TARGETS ) ? MAX_VIEW_DISTANCE :
+                      std::max( type->vision_day, type->vision_night );
+    const auto in_range = [this, range]( const Creature & critter ) {
+        return rl_dist( pos(), critter.pos() ) <= range;
+    };
+    const auto hostile_faction = [this]( const mfaction_id & other ) {
+        const mf_attitude att = faction.obj().attitude( other );
+        return att != MFA_NEUTRAL && att != MFA_FRIENDLY;
+    };
+
+    if( friendly == 0 && in_range( g->u ) ) {
+        ret.push_back( &g->u );
+    }
+    for( npc &who : g->all_npcs() ) {
+        if( in_range( who ) && hostile_faction( who.get_monster_faction() ) ) {
+            ret.push_back( &who );
+        }
+    }
+    // Same as in plan: own faction only matters for swarming and group morale
+    const bool own_faction = has_flag( MF_SWARMS ) ||
+                             ( has_flag( MF_GROUP_MORALE ) && morale < type->morale );
+    const mfaction_id actual_faction = friendly == 0 ? faction :
+                                       mfaction_id( mfaction_str_id( "player" ) );
+    const tripoint reach( range, range, fov_3d ? range : 0 );
+    for( const shared_ptr_fast<monster> &mon : g->critter_tracker->find_in_cuboid( pos() - reach,
+            pos() + reach ) ) {
+        if( mon.get() == this || !in_range( *mon ) ) {
+            continue;
+        }
+        const bool target = friendly == 0 ? hostile_faction( mon->faction ) : mon->friendly == 0;
+        if( target || ( own_faction && mon->faction == actual_faction ) ) {
+            ret.push_back( mon.get() );
+        }
+    }
+    return ret;
+}
+
+void monster::plan_sights( const std::vector<Creature *> &candidates )
+{
+    planned_sights.clear();
+    planned_sights_pos = pos();
+    for( const Creature *critter : candidates ) {
+        planned_sights.push_back( { critter, critter->pos(), sees( *critter ) } );
+    }
+    std::sort( planned_sights.begin(), planned_sights.end(),
+    []( const planned_sight & lhs, const planned_sight & rhs ) {
+        return lhs.target < rhs.target;
+    } );
+}
+
+void monster::forget_planned_sights()
+{
+    planned_sights.clear();
+}
+
+bool monster::sees_planned( const Creature &c ) const
+{
+    if( !planned_sights.empty() && planned_sights_pos == pos() ) {
+        const auto iter = std::lower_bound( planned_sights.begin(), planned_sights.end(), &c,
+        []( const planned_sight & sight, const Creature * target ) {
+            return sight.target < target;
+        } );
+        if( iter != planned_sights.end() && iter->target == &c && iter->target_pos == c.pos() ) {
+            return iter->seen;
+        }
+    }
+    const map &here = get_map();
+    here.begin_target_sight_checks();
+    const bool seen = sees( c );
+    here.end_target_sight_checks();
+    return seen;
+}
+
 void monster::plan()
 {
     const auto &factions = g->critter_tracker->factions();
@@ -338,7 +422,7 @@ void monster::plan()
     auto mood = attitude();
 
     // If we can see the player, move toward them or flee, simpleminded animals are too dumb to follow the player.
-    if( friendly == 0 && sees( g->u ) && !waiting ) {
+    if( friendly == 0 && sees_planned( g->u ) && !waiting ) {
         dist = rate_target( g->u, dist, smart_planning );
         fleeing = fleeing || is_fleeing( g->u );
         target = &g->u;
@@ -581,7 +665,7 @@ void monster::plan()
     } else if( friendly > 0 && one_in( 3 ) ) {
         // Grow restless with no targets
         friendly--;
-    } else if( friendly < 0 && sees( g->u ) && !has_flag( MF_PET_WONT_FOLLOW ) ) {
+    } else if( friendly < 0 && sees_planned( g->u ) && !has_flag( MF_PET_WONT_FOLLOW ) ) {
         if( rl_dist( pos(), g->u.pos() ) > 2 ) {
             set_dest( g->u.pos() );
         } else {
@@ -842,10 +926,18 @@ void monster::move()
             }
 
             const auto &pf_settings = get_pathfinding_settings();
-            if( pf_settings.max_dist >= rl_dist( pos(), goal ) &&
-                ( path.empty() || rl_dist( pos(), path.front() ) >= 2 || path.back() != goal ) ) {
-                // We need a new path
-                path = g->m.route( pos(), goal, pf_settings, get_path_avoid() );
+            if( pf_settings.max_dist >= rl_dist( pos(), goal ) ) {
+                const std::set<tripoint> avoid = get_path_avoid();
+                if( !g->m.repair_route( path, path_cache, pos(), goal, pf_settings, avoid ) ) {
+                    // We need a new path
+                    if( avoid.empty() ) {
+                        // Hordes often share a goal, let them share the search too
+                        path = g->m.route_to_shared_target( pos(), goal, pf_settings );
+                    } else {
+                        path = g->m.route( pos(), goal, pf_settings, avoid );
+                    }
+                    g->m.remember_route( path, path_cache, pos(), pf_settings );
+                }
             }
 
             // Try to respect old paths, even if we can't pathfind at the moment
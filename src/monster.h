@@ -22,6 +22,7 @@
 #include "effect.h"
 #include "enums.h"
 #include "optional.h"
+#include "pathfinding.h"
 #include "pldata.h"
 #include "point.h"
 #include "type_id.h"
@@ -218,6 +219,15 @@ class monster : public Creature, public visitable<monster>
         // How good of a target is given creature (checks for visibility)
         float rate_target( Creature &c, float best, bool smart = false ) const;
         void plan();
+        /**
+         * Creatures whose visibility @ref plan may check, see game::monmove.
+         * Visibility of those is checked ahead of time by @ref plan_sights, which only reads
+         * shared state and may run on any thread. @ref plan uses the answers for as long as
+         * neither side has moved, until @ref forget_planned_sights.
+         */
+        std::vector<Creature *> sight_candidates() const;
+        void plan_sights( const std::vector<Creature *> &candidates );
+        void forget_planned_sights();
         void move(); // Actual movement
         void footsteps( const tripoint &p ); // noise made by movement
         void shove_vehicle( const tripoint &remote_destination,
@@ -568,6 +578,20 @@ class monster : public Creature, public visitable<monster>
         monster_horde_attraction horde_attraction;
         /** Found path. Note: Not used by monsters that don't pathfind! **/
         std::vector<tripoint> path;
+        route_cache path_cache;
+        struct planned_sight {
+            const Creature *target;
+            tripoint target_pos;
+            bool seen;
+        };
+        /** Answers of @ref plan_sights, sorted by target. */
+        std::vector<planned_sight> planned_sights;
+        tripoint planned_sights_pos;
+        /**
+         * Same as @ref sees, but answered by @ref plan_sights if it still can be.
+         * Sees registered targets through map::begin_target_sight_checks.
+         */
+        bool sees_planned( const Creature &c ) const;
         std::bitset<NUM_MEFF> effect_cache;
         cata::optional<time_duration> summon_time_limit = cata::nullopt;
 
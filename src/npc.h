@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <functional>
 #include <iosfwd>
 #include <iterator>
@@ -31,7 +32,9 @@
 #include "item_location.h"
 #include "line.h"
 #include "lru_cache.h"
+#include "memory_fast.h"
 #include "optional.h"
+#include "pathfinding.h"
 #include "pimpl.h"
 #include "player.h"
 #include "point.h"
@@ -561,6 +564,9 @@ struct npc_short_term_cache {
     std::map<direction, float> threat_map;
     // Cache of locations the NPC has searched recently in npc::find_item()
     lru_cache<tripoint, int> searched_tiles;
+    // When find_item() and find_job_to_perform() last searched, see npc_perception
+    time_point last_item_search = calendar::before_time_starts;
+    time_point last_job_search = calendar::before_time_starts;
 };
 
 // DO NOT USE! This is old, use strings as talk topic instead, e.g. "TALK_AGREE_FOLLOW" instead of
@@ -1292,6 +1298,8 @@ class npc : public player
         tripoint global_square_location() const override;
         cata::optional<tripoint> last_player_seen_pos; // Where we last saw the player
         int last_seen_player_turn = 0; // Timeout to forgetting
+        // Time spent in move() since the debug hour timer last reported
+        std::chrono::microseconds ai_time = std::chrono::microseconds::zero();
         tripoint wanted_item_pos; // The square containing an item we want
         tripoint guard_pos;  // These are the local coordinates that a guard will return to inside of their goal tripoint
         tripoint chair_pos = tripoint_min; // This is the spot the NPC wants to move to to sit and relax.
@@ -1313,6 +1321,7 @@ class npc : public player
         int worst_item_value = 0; // The value of our least-wanted item
 
         std::vector<tripoint> path; // Our movement plans
+        route_cache path_cache;
 
         // Personality & other defining characteristics
         std::string companion_mission_role_id; //Set mission source or squad leader for a patrol
@@ -1427,4 +1436,42 @@ std::ostream &operator<< ( std::ostream &os, const npc_need &need );
 /** Opens a menu and allows player to select a friendly NPC. */
 npc *pick_follower();
 
+/**
+ * What every NPC would otherwise look up on its own while deciding what to do,
+ * gathered once per turn, and the searches of their surroundings they take turns at.
+ *
+ * An NPC searches for items at most once per turn and for a job at most once every
+ * ten minutes, and only so many searches start in one turn. NPCs that are turned down
+ * get the first searches of the next turn, the ones that have waited longest first.
+ */
+class npc_perception
+{
+    public:
+        /** Searches all NPCs together may start in one turn. */
+        static constexpr int searches_per_turn = 4;
+
+        /** NPCs following the player, who keep an eye out for thieves. */
+        const std::vector<shared_ptr_fast<npc>> &followers();
+        /** Whether @p guy may search its surroundings now, or has to wait its turn. */
+        bool may_search( const npc &guy );
+
+        // Counted since the debug hour timer last reported
+        int searches = 0;
+        int postponed = 0;
+
+    private:
+        void refresh();
+
+        time_point turn = calendar::before_time_starts;
+        std::set<character_id> follower_ids;
+        std::vector<shared_ptr_fast<npc>> follower_npcs;
+        int searches_left = 0;
+        // NPCs that were turned down, and since when
+        std::map<character_id, time_point> waiting;
+        // Searches kept for some of those this turn
+        std::set<character_id> reserved;
+};
+
+npc_perception &get_npc_perception();
+
 #endif // CATA_SRC_NPC_H
@@ -364,6 +364,23 @@ static bool too_close( const tripoint &critter_pos, const tripoint &ally_pos, co
     return rl_dist( critter_pos, ally_pos ) <= def_radius;
 }
 
+// Whether the field cache has fields in any submap within radius of p
+static bool fields_nearby( const map &here, const tripoint &p, const int radius )
+{
+    const level_cache &cache = here.get_cache_ref( p.z );
+    const point min( std::max( 0, ( p.x - radius ) / SEEX ), std::max( 0, ( p.y - radius ) / SEEY ) );
+    const point max( std::min( MAPSIZE - 1, ( p.x + radius ) / SEEX ),
+                     std::min( MAPSIZE - 1, ( p.y + radius ) / SEEY ) );
+    for( int y = min.y; y <= max.y; y++ ) {
+        for( int x = min.x; x <= max.x; x++ ) {
+            if( cache.field_cache[x + y * MAPSIZE] ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void npc::assess_danger()
 {
     float assessment = 0.0f;
@@ -431,18 +448,19 @@ void npc::assess_danger()
     }
     map &here = get_map();
     // first, check if we're about to be consumed by fire
-    // TODO: Use the field cache
-    for( const tripoint &pt : here.points_in_radius( pos(), 6 ) ) {
-        if( pt == pos() || here.has_flag( TFLAG_FIRE_CONTAINER,  pt ) ) {
-            continue;
-        }
-        if( here.get_field( pt, fd_fire ) != nullptr ) {
-            int dist = rl_dist( pos(), pt );
-            cur_threat_map[direction_from( pos(), pt )] += 2.0f * ( NPC_DANGER_MAX - dist );
-            if( dist < 3 && !has_effect( effect_npc_fire_bad ) ) {
-                warn_about( "fire_bad", 1_minutes );
-                add_effect( effect_npc_fire_bad, 5_turns );
-                path.clear();
+    if( fields_nearby( here, pos(), 6 ) ) {
+        for( const tripoint &pt : here.points_in_radius( pos(), 6 ) ) {
+            if( pt == pos() || here.has_flag( TFLAG_FIRE_CONTAINER,  pt ) ) {
+                continue;
+            }
+            if( here.get_field( pt, fd_fire ) != nullptr ) {
+                int dist = rl_dist( pos(), pt );
+                cur_threat_map[direction_from( pos(), pt )] += 2.0f * ( NPC_DANGER_MAX - dist );
+                if( dist < 3 && !has_effect( effect_npc_fire_bad ) ) {
+                    warn_about( "fire_bad", 1_minutes );
+                    add_effect( effect_npc_fire_bad, 5_turns );
+                    path.clear();
+                }
             }
         }
     }
@@ -892,7 +910,8 @@ void npc::move()
             }
         }
         if( assigned_camp && attitude != NPCATT_ACTIVITY ) {
-            if( has_job() && calendar::once_every( 10_minutes ) && find_job_to_perform() ) {
+            if( has_job() && calendar::turn - ai_cache.last_job_search >= 10_minutes &&
+                get_npc_perception().may_search( *this ) && find_job_to_perform() ) {
                 action = npc_player_activity;
             } else {
                 action = npc_worker_downtime;
@@ -2173,20 +2192,15 @@ bool npc::update_path( const tripoint &p, const bool no_bashing, bool force )
         return true;
     }
 
-    while( !path.empty() && path[0] == pos() ) {
-        path.erase( path.begin() );
-    }
-
-    if( !path.empty() ) {
-        const tripoint &last = path[path.size() - 1];
-        if( last == p && ( path[0].z != posz() || rl_dist( path[0], pos() ) <= 1 ) ) {
-            // Our path already leads to that point, no need to recalculate
-            return true;
-        }
+    map &here = get_map();
+    const pathfinding_settings &settings = get_pathfinding_settings( no_bashing );
+    const std::set<tripoint> avoid = get_path_avoid();
+    if( here.repair_route( path, path_cache, pos(), p, settings, avoid ) ) {
+        // Our path already leads to that point, or needed only small changes to do so
+        return true;
     }
 
-    auto new_path = get_map().route( pos(), p, get_pathfinding_settings( no_bashing ),
-                                     get_path_avoid() );
+    auto new_path = here.route( pos(), p, settings, avoid );
     if( new_path.empty() ) {
         if( !ai_cache.sound_alerts.empty() ) {
             ai_cache.sound_alerts.erase( ai_cache.sound_alerts.begin() );
@@ -2203,6 +2217,7 @@ bool npc::update_path( const tripoint &p, const bool no_bashing, bool force )
 
     if( !new_path.empty() || force ) {
         path = std::move( new_path );
+        here.remember_route( path, path_cache, pos(), settings );
         return true;
     }
 
@@ -2574,6 +2589,7 @@ void npc::move_away_from( const tripoint &pt, bool no_bash_atk, std::set<tripoin
 
 bool npc::find_job_to_perform()
 {
+    ai_cache.last_job_search = calendar::turn;
     for( activity_id &elem : job.get_prioritised_vector() ) {
         if( job.get_priority_of_job( elem ) == 0 ) {
             continue;
@@ -2799,6 +2815,11 @@ void npc::find_item()
         return;
     }
 
+    if( ai_cache.last_item_search == calendar::turn || !get_npc_perception().may_search( *this ) ) {
+        return;
+    }
+    ai_cache.last_item_search = calendar::turn;
+
     fetching_item = false;
     int best_value = minimum_item_value();
     // Not perfect, but has to mirror pickup code
@@ -2819,27 +2840,34 @@ void npc::find_item()
         return;
     }
 
+    const std::vector<shared_ptr_fast<npc>> &followers = get_npc_perception().followers();
+    Character &player_character = get_player_character();
+    const auto watched = [&followers, &player_character]( const tripoint & p ) {
+        return player_character.sees( p ) ||
+        std::any_of( followers.begin(), followers.end(), [&p]( const shared_ptr_fast<npc> &elem ) {
+            return elem->sees( p );
+        } );
+    };
+    // Nobody watches out for thieves without followers. Where we stand doesn't change
+    // during the search, where the best item so far lies is checked again when it moves.
+    const bool watched_here = !followers.empty() && watched( pos() );
+    tripoint watched_spot = tripoint_min;
+    bool watched_there = false;
+
     const auto consider_item =
-        [&wanted, &best_value, whitelisting, volume_allowed, weight_allowed, this]
+        [&wanted, &best_value, whitelisting, volume_allowed, weight_allowed, this,
+         &followers, &watched, watched_here, &watched_spot, &watched_there]
     ( const item & it, const tripoint & p ) {
         if( it.made_of( LIQUID ) ) {
             // Don't even consider liquids.
             return;
         }
-        std::vector<npc *> followers;
-        for( auto &elem : g->get_follower_list() ) {
-            shared_ptr_fast<npc> npc_to_get = overmap_buffer.find_npc( elem );
-            if( !npc_to_get ) {
-                continue;
+        if( !followers.empty() && !it.is_owned_by( *this, true ) ) {
+            if( watched_spot != wanted_item_pos ) {
+                watched_spot = wanted_item_pos;
+                watched_there = watched( wanted_item_pos );
             }
-            npc *npc_to_add = npc_to_get.get();
-            followers.push_back( npc_to_add );
-        }
-        Character &player_character = get_player_character();
-        for( auto &elem : followers ) {
-            if( !it.is_owned_by( *this, true ) && ( player_character.sees( this->pos() ) ||
-                                                    player_character.sees( wanted_item_pos ) ||
-                                                    elem->sees( this->pos() ) || elem->sees( wanted_item_pos ) ) ) {
+            if( watched_here || watched_there ) {
                 return;
             }
         }
@@ -4259,7 +4287,9 @@ void npc::go_to_omt_destination()
             }
         }
     }
-    path = here.route( pos(), centre_sub, get_pathfinding_settings(), get_path_avoid() );
+    const pathfinding_settings &settings = get_pathfinding_settings();
+    path = here.route( pos(), centre_sub, settings, get_path_avoid() );
+    here.remember_route( path, path_cache, pos(), settings );
     add_msg( m_debug, "%s going %s->%s", name, omt_pos.to_string(), goal.to_string() );
 
     if( !path.empty() ) {
@@ -4648,3 +4678,70 @@ void npc::set_movement_mode( character_movemode new_mode )
 {
     move_mode = new_mode;
 }
+
+npc_perception &get_npc_perception()
+{
+    static npc_perception perception;
+    return perception;
+}
+
+void npc_perception::refresh()
+{
+    const bool new_turn = turn != calendar::turn;
+    if( new_turn ) {
+        turn = calendar::turn;
+        // Those offered a search last turn that didn't take it no longer need one
+        for( const character_id &id : reserved ) {
+            waiting.erase( id );
+        }
+        reserved.clear();
+        std::vector<std::pair<time_point, character_id>> queue;
+        for( const std::pair<const character_id, time_point> &elem : waiting ) {
+            queue.emplace_back( elem.second, elem.first );
+        }
+        std::sort( queue.begin(), queue.end() );
+        for( const std::pair<time_point, character_id> &elem : queue ) {
+            if( static_cast<int>( reserved.size() ) >= searches_per_turn ) {
+                break;
+            }
+            reserved.insert( elem.second );
+        }
+        searches_left = searches_per_turn - static_cast<int>( reserved.size() );
+    }
+    // Hired or dismissed since the start of the turn
+    std::set<character_id> ids = g->get_follower_list();
+    if( new_turn || ids != follower_ids ) {
+        follower_ids = std::move( ids );
+        follower_npcs.clear();
+        for( const character_id &id : follower_ids ) {
+            shared_ptr_fast<npc> guy = overmap_buffer.find_npc( id );
+            if( guy ) {
+                follower_npcs.emplace_back( std::move( guy ) );
+            }
+        }
+    }
+}
+
+const std::vector<shared_ptr_fast<npc>> &npc_perception::followers()
+{
+    refresh();
+    return follower_npcs;
+}
+
+bool npc_perception::may_search( const npc &guy )
+{
+    refresh();
+    const character_id id = guy.getID();
+    if( reserved.erase( id ) == 0 ) {
+        if( searches_left <= 0 ) {
+            // Keeps its place if it has been waiting already
+            waiting.emplace( id, calendar::turn );
+            postponed++;
+            return false;
+        }
+        searches_left--;
+    }
+    waiting.erase( id );
+    searches++;
+    return true;
+}
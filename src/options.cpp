@@ -2198,6 +2198,26 @@ void options_manager::add_options_debug()
          true
        );
 
+    add( "OVERMAP_PREPARE_DISTANCE", "debug", translate_marker( "Overmap preparation distance" ),
+         translate_marker( "When you get this many overmap tiles close to the edge of an overmap, the neighbouring overmap will be loaded or generated ahead of time, so crossing into it won't freeze the game.  Set to 0 to disable." ),
+         0, OMAPX / 2, 24
+       );
+
+    add( "WORKER_THREADS", "debug", translate_marker( "Worker threads" ),
+         translate_marker( "Number of threads used to cast light and vision and to plan monster moves.  The results are the same with any number of threads.  1 forces single-threaded operation, 0 uses one thread per CPU core." ),
+         0, 64, 0
+       );
+
+    add( "PARALLEL_MONSTER_PLANNING", "debug", translate_marker( "Plan monster moves in parallel" ),
+         translate_marker( "If true, monsters look for targets on the worker threads at the start of their turns, using the map as it was then.  If false, each monster looks when it moves, after the ones before it moved." ),
+         false
+       );
+
+    add( "FAST_FORWARD", "debug", translate_marker( "Fast-forward quiet turns" ),
+         translate_marker( "If true, while you sleep or are busy with an activity and no hostile is around, your needs and healing are updated once a minute instead of every turn and the screen is redrawn less often.  Stops as soon as a hostile comes near." ),
+         true
+       );
+
     add( "ELECTRIC_GRID", "debug", translate_marker( "Electric grid testing" ),
          translate_marker( "If true, enables somewhat unfinished electric grid system that may slow the game down." ),
          true
@@ -3339,6 +3359,10 @@ void options_manager::cache_to_globals()
     message_cooldown = ::get_option<int>( "MESSAGE_COOLDOWN" );
     fov_3d = ::get_option<bool>( "FOV_3D" );
     fov_3d_z_range = ::get_option<int>( "FOV_3D_Z_RANGE" );
+    overmap_prepare_distance = ::get_option<int>( "OVERMAP_PREPARE_DISTANCE" );
+    worker_threads = ::get_option<int>( "WORKER_THREADS" );
+    parallel_monster_planning = ::get_option<bool>( "PARALLEL_MONSTER_PLANNING" );
+    fast_forward = ::get_option<bool>( "FAST_FORWARD" );
     static_z_effect = ::get_option<bool>( "STATICZEFFECT" );
     PICKUP_RANGE = ::get_option<int>( "PICKUP_RANGE" );
 #if defined(SDL_SOUND)
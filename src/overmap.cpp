@@ -12,6 +12,7 @@
 #include <numeric>
 #include <ostream>
 #include <set>
+#include <sstream>
 #include <unordered_set>
 #include <vector>
 
@@ -1171,6 +1172,20 @@ void overmap::populate( overmap_special_batch &enabled_specials )
     }
 }
 
+void overmap::populate( const overmap_file_contents &contents )
+{
+    try {
+        std::istringstream ter_stream( contents.terrain );
+        unserialize( ter_stream, overmapbuffer::terrain_filename( loc ) );
+        if( !contents.view.empty() ) {
+            std::istringstream view_stream( contents.view );
+            unserialize_view( view_stream, overmapbuffer::player_filename( loc ) );
+        }
+    } catch( const std::exception &err ) {
+        debugmsg( "overmap %s failed to load: %s", loc.to_string(), err.what() );
+    }
+}
+
 void overmap::populate()
 {
     overmap_special_batch enabled_specials = overmap_specials::get_default_batch( loc );
@@ -1247,6 +1262,27 @@ void overmap::init_layers()
     }
 }
 
+void overmap::unpack_terrain( int z ) const
+{
+    std::vector<std::pair<oter_id, int>> &runs = packed_terrain[z];
+    if( runs.empty() ) {
+        return;
+    }
+    // Unpacking does not change what the overmap looks like from the outside,
+    // which is why this is allowed on a const overmap.
+    oter_id( &terrain )[OMAPX][OMAPY] = const_cast<map_layer &>( layer[z] ).terrain;
+    int pos = 0;
+    for( const std::pair<oter_id, int> &run : runs ) {
+        for( int n = 0; n < run.second; ++n, ++pos ) {
+            terrain[pos % OMAPX][pos / OMAPX] = run.first;
+        }
+    }
+    runs.clear();
+    runs.shrink_to_fit();
+}
+
+unsigned overmap::terrain_revision = 0;
+
 void overmap::ter_set( const tripoint_om_omt &p, const oter_id &id )
 {
     if( !inbounds( p ) ) {
@@ -1254,7 +1290,12 @@ void overmap::ter_set( const tripoint_om_omt &p, const oter_id &id )
         return;
     }
 
-    layer[p.z() + OVERMAP_DEPTH].terrain[p.x()][p.y()] = id;
+    unpack_terrain( p.z() + OVERMAP_DEPTH );
+    oter_id &current = layer[p.z() + OVERMAP_DEPTH].terrain[p.x()][p.y()];
+    if( current != id ) {
+        current = id;
+        terrain_revision++;
+    }
 }
 
 const oter_id &overmap::ter( const tripoint_om_omt &p ) const
@@ -1264,6 +1305,7 @@ const oter_id &overmap::ter( const tripoint_om_omt &p ) const
         return ot_null;
     }
 
+    unpack_terrain( p.z() + OVERMAP_DEPTH );
     return layer[p.z() + OVERMAP_DEPTH].terrain[p.x()][p.y()];
 }
 
@@ -2208,8 +2250,9 @@ void mongroup::wander( const overmap &om )
 
 void overmap::move_hordes()
 {
-    // Prevent hordes to be moved twice by putting them in here after moving.
-    decltype( zg ) tmpzg;
+    // Prevent hordes to be moved twice by taking them out after moving and putting them back
+    // at the end. Only the map nodes are relinked, the groups and their monsters stay put.
+    std::vector<decltype( zg )::node_type> moved;
     //MOVE ZOMBIE GROUPS
     for( auto it = zg.begin(); it != zg.end(); ) {
         mongroup &mg = it->second;
@@ -2263,15 +2306,17 @@ void overmap::move_hordes()
                 mg.pos.y()++;
             }
 
-            // Erase the group at it's old location, add the group with the new location
-            tmpzg.insert( std::pair<tripoint_om_sm, mongroup>( mg.pos, mg ) );
-            zg.erase( it++ );
+            // Take the group out from its old location, it goes back in with the new one
+            moved.push_back( zg.extract( it++ ) );
+            moved.back().key() = mg.pos;
         } else {
             ++it;
         }
     }
-    // and now back into the monster group map.
-    zg.insert( tmpzg.begin(), tmpzg.end() );
+    // and now back into the monster group map, in the order they moved
+    for( decltype( zg )::node_type &node : moved ) {
+        zg.insert( std::move( node ) );
+    }
 
     if( get_option<bool>( "WANDER_SPAWNS" ) ) {
 
@@ -2322,14 +2367,15 @@ void overmap::move_hordes()
             // Check again if the zombie will join the largest horde, now that we know the accurate size.
             if( this_monster.will_join_horde( add_to_horde_size ) ) {
                 // If there is no horde to add the monster to, create one.
+                // The monster is erased below, so it can be moved instead of copied
                 if( add_to_group == nullptr ) {
                     mongroup m( GROUP_ZOMBIE, p, 1, 0 );
                     m.horde = true;
-                    m.monsters.push_back( this_monster );
+                    m.monsters.push_back( std::move( this_monster ) );
                     m.interest = 0; // Ensures that we will select a new target.
-                    add_mon_group( m );
+                    zg.emplace( p, std::move( m ) );
                 } else {
-                    add_to_group->monsters.push_back( this_monster );
+                    add_to_group->monsters.push_back( std::move( this_monster ) );
                 }
             } else { // Bad luck--the zombie would have joined a larger horde, but not this one.  Skip.
                 // Don't delete the monster, just increment the iterator.
@@ -2350,8 +2396,13 @@ void overmap::move_hordes()
 void overmap::signal_hordes( const tripoint_rel_sm &p_rel, const int sig_power )
 {
     tripoint_om_sm p( p_rel.raw() );
-    for( auto &elem : zg ) {
-        mongroup &mg = elem.second;
+    // Groups are ordered by x first, so the ones further away than that along x are skipped
+    // without looking at them
+    const int reach = std::max( 0, sig_power );
+    const auto first = zg.lower_bound( tripoint_om_sm( p.x() - reach, INT_MIN, INT_MIN ) );
+    const auto last = zg.upper_bound( tripoint_om_sm( p.x() + reach, INT_MAX, INT_MAX ) );
+    for( auto it = first; it != last; ++it ) {
+        mongroup &mg = it->second;
         if( !mg.horde ) {
             continue;
         }
@@ -43,6 +43,7 @@ class overmap_connection;
 class overmap_special;
 class overmap_special_batch;
 struct om_special_sectors;
+struct overmap_file_contents;
 struct regional_settings;
 template <typename E> struct enum_traits;
 
@@ -190,6 +191,10 @@ class overmap
          **/
         void populate( overmap_special_batch &enabled_specials );
         void populate();
+        /**
+         * Load the overmap from the already read contents of its save files.
+         **/
+        void populate( const overmap_file_contents &contents );
 
         const point_abs_om &pos() const {
             return loc;
@@ -215,6 +220,12 @@ class overmap
          */
         std::vector<point_abs_omt> find_terrain( const std::string &term, int zlevel );
 
+        /**
+         * Changes whenever overmap terrain is changed and whenever overmaps are added or
+         * removed, so that anything worked out from the terrain can tell if it is outdated.
+         */
+        static unsigned terrain_revision;
+
         void ter_set( const tripoint_om_omt &p, const oter_id &id );
         const oter_id &ter( const tripoint_om_omt &p ) const;
         bool &seen( const tripoint_om_omt &p );
@@ -289,6 +300,10 @@ class overmap
         }
 
         void clear_mon_groups();
+        void add_mon_group( const mongroup &group );
+        void signal_hordes( const tripoint_rel_sm &p, int sig_power );
+        void process_mongroups();
+        void move_hordes();
         void clear_overmap_special_placements();
         void clear_cities();
         void clear_labs();
@@ -344,6 +359,13 @@ class overmap
         point_abs_om loc;
 
         std::array<map_layer, OVERMAP_LAYERS> layer;
+        /**
+         * Terrain of z-levels that have been loaded from disk but not accessed yet,
+         * as runs of (terrain, length) in the order used by the save file.
+         * An empty vector means the terrain in @ref layer is up to date.
+         * See @ref unpack_terrain.
+         */
+        mutable std::array<std::vector<std::pair<oter_id, int>>, OVERMAP_LAYERS> packed_terrain;
         std::unordered_map<tripoint_abs_omt, scent_trace> scents;
 
         // Records the locations where a given overmap special was placed, which
@@ -358,6 +380,14 @@ class overmap
 
         // Initialize
         void init_layers();
+        /**
+         * Expand the packed terrain of the given layer (0 based index) into @ref layer,
+         * if it has not been done yet.
+         */
+        void unpack_terrain( int z ) const;
+        // Set up @ref packed_terrain from the terrain ids and runs read from a save file
+        void load_packed_terrain( const std::vector<std::string> &ids,
+                                  const std::array<std::vector<int>, OVERMAP_LAYERS> &runs );
         // open existing overmap, or generate a new one
         void open( overmap_special_batch &enabled_specials );
     public:
@@ -387,10 +417,6 @@ class overmap
 
         const city &get_nearest_city( const tripoint_om_omt &p ) const;
 
-        void signal_hordes( const tripoint_rel_sm &p, int sig_power );
-        void process_mongroups();
-        void move_hordes();
-
         static bool is_obsolete_terrain( const std::string &ter );
         void convert_terrain( const std::unordered_map<tripoint_om_omt, std::string> &needs_conversion );
 
@@ -490,8 +516,6 @@ class overmap
         void place_mongroups();
         void place_radios();
 
-        void add_mon_group( const mongroup &group );
-
         void load_monster_groups( JsonIn &jsin );
         void load_legacy_monstergroups( JsonIn &jsin );
         void save_monster_groups( JsonOut &jo ) const;
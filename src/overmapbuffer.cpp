@@ -3,13 +3,17 @@
 #include <algorithm>
 #include <cassert>
 #include <climits>
+#include <exception>
 #include <iterator>
 #include <list>
 #include <map>
 #include <queue>
+#include <sstream>
+#include <tuple>
 
 #include "avatar.h"
 #include "basecamp.h"
+#include "cached_options.h"
 #include "calendar.h"
 #include "cata_utility.h"
 #include "character_id.h"
@@ -19,6 +23,7 @@
 #include "coordinates.h"
 #include "debug.h"
 #include "filesystem.h"
+#include "fstream_utils.h"
 #include "game.h"
 #include "game_constants.h"
 #include "int_id.h"
@@ -92,11 +97,16 @@ overmap &overmapbuffer::get( const point_abs_om &p )
 
     // That constructor loads an existing overmap or creates a new one.
     overmap &new_om = *( overmaps[ p ] = std::make_unique<overmap>( p ) );
-    new_om.populate();
+    if( cata::optional<overmap_file_contents> contents = take_pending_load( p ) ) {
+        new_om.populate( *contents );
+    } else {
+        new_om.populate();
+    }
     // Note: fix_mongroups might load other overmaps, so overmaps.back() is not
     // necessarily the overmap at (x,y)
     fix_mongroups( new_om );
     fix_npcs( new_om );
+    overmap::terrain_revision++;
 
     last_requested_overmap = &new_om;
     return new_om;
@@ -110,8 +120,130 @@ void overmapbuffer::create_custom_overmap( const point_abs_om &p, overmap_specia
             last_requested_overmap = nullptr;
         }
     }
+    // The custom overmap replaces whatever might have been on disk.
+    take_pending_load( p );
     overmap &new_om = *( overmaps[ p ] = std::make_unique<overmap>( p ) );
     new_om.populate( specials );
+    overmap::terrain_revision++;
+}
+
+/**
+ * Reads the save files of an overmap. This runs on a worker thread, so it must
+ * not touch any game state and must not report errors via debugmsg: any failure
+ * simply yields nothing and the overmap gets loaded the usual way.
+ */
+static cata::optional<overmap_file_contents> read_overmap_files( const std::string &terrain_path,
+        const std::string &view_path )
+{
+    const auto read_all = []( const std::string & path ) -> cata::optional<std::string> {
+        cata_ifstream fin = std::move( cata_ifstream().mode( cata_ios_mode::binary ).open( path ) );
+        if( !fin.is_open() )
+        {
+            return cata::nullopt;
+        }
+        std::ostringstream buffer;
+        buffer << fin->rdbuf();
+        if( fin.bad() )
+        {
+            return cata::nullopt;
+        }
+        return buffer.str();
+    };
+
+    overmap_file_contents contents;
+    if( cata::optional<std::string> terrain = read_all( terrain_path ) ) {
+        contents.terrain = std::move( *terrain );
+    } else {
+        return cata::nullopt;
+    }
+    if( file_exist( view_path ) ) {
+        if( cata::optional<std::string> view = read_all( view_path ) ) {
+            contents.view = std::move( *view );
+        } else {
+            return cata::nullopt;
+        }
+    }
+    return contents;
+}
+
+void overmapbuffer::request_load( const point_abs_om &p )
+{
+    if( pending_loads.count( p ) > 0 ) {
+        return;
+    }
+#if defined(OVERMAP_READ_AHEAD_SYNC)
+    pending_loads.emplace( p, read_overmap_files( terrain_filename( p ), player_filename( p ) ) );
+#else
+    // The file names depend on game state, so they are built here on the main thread.
+    pending_loads.emplace( p, std::async( std::launch::async, read_overmap_files,
+                                          terrain_filename( p ), player_filename( p ) ) );
+#endif
+}
+
+cata::optional<overmap_file_contents> overmapbuffer::take_pending_load( const point_abs_om &p )
+{
+    const auto it = pending_loads.find( p );
+    if( it == pending_loads.end() ) {
+        return cata::nullopt;
+    }
+    pending_overmap_load pending = std::move( it->second );
+    pending_loads.erase( it );
+#if defined(OVERMAP_READ_AHEAD_SYNC)
+    return pending;
+#else
+    try {
+        return pending.get();
+    } catch( const std::exception & ) {
+        return cata::nullopt;
+    }
+#endif
+}
+
+void overmapbuffer::prepare_neighbors( const tripoint_abs_omt &p )
+{
+    const int distance = overmap_prepare_distance;
+    if( distance <= 0 ) {
+        return;
+    }
+    point_abs_om om_pos;
+    point_om_omt local;
+    std::tie( om_pos, local ) = project_remain<coords::om>( p.xy() );
+    const auto edge_direction = [distance]( int v, int size ) {
+        if( v < distance ) {
+            return -1;
+        }
+        return v >= size - distance ? 1 : 0;
+    };
+    const point dir( edge_direction( local.x(), OMAPX ), edge_direction( local.y(), OMAPY ) );
+    if( dir == point_zero ) {
+        return;
+    }
+
+    std::vector<point_abs_om> neighbors;
+    if( dir.x != 0 ) {
+        neighbors.push_back( om_pos + point( dir.x, 0 ) );
+    }
+    if( dir.y != 0 ) {
+        neighbors.push_back( om_pos + point( 0, dir.y ) );
+    }
+    if( dir.x != 0 && dir.y != 0 ) {
+        neighbors.push_back( om_pos + dir );
+    }
+
+    bool generated = false;
+    for( const point_abs_om &neighbor : neighbors ) {
+        if( overmaps.count( neighbor ) > 0 || pending_loads.count( neighbor ) > 0 ) {
+            continue;
+        }
+        if( file_exist( terrain_filename( neighbor ) ) ) {
+            request_load( neighbor );
+        } else if( !generated ) {
+            // Generation uses the global RNG and reads neighbouring overmaps,
+            // so it has to happen here on the main thread.
+            get( neighbor );
+            generated = true;
+        }
+    }
 }
 
 void overmapbuffer::fix_mongroups( overmap &new_overmap )
@@ -209,9 +341,13 @@ void overmapbuffer::save()
 
 void overmapbuffer::clear()
 {
+    // Destroying the futures waits for the reads still in progress.
+    pending_loads.clear();
     overmaps.clear();
     known_non_existing.clear();
     last_requested_overmap = nullptr;
+    travel_paths.clear();
+    overmap::terrain_revision++;
 }
 
 const regional_settings &overmapbuffer::get_settings( const tripoint_abs_omt &p )
@@ -705,6 +841,17 @@ bool overmapbuffer::reveal( const tripoint_abs_omt &center, int radius,
     return result;
 }
 
+bool overmap_path_params::operator==( const overmap_path_params &rhs ) const
+{
+    const auto as_tuple = []( const overmap_path_params & p ) {
+        return std::make_tuple( p.road_cost, p.field_cost, p.dirt_road_cost, p.trail_cost,
+                                p.forest_cost, p.small_building_cost, p.shore_cost, p.swamp_cost,
+                                p.water_cost, p.air_cost, p.other_cost, p.avoid_danger,
+                                p.only_known_by_player );
+    };
+    return as_tuple( *this ) == as_tuple( rhs );
+}
+
 overmap_path_params overmap_path_params::for_player()
 {
     overmap_path_params ret;
@@ -763,15 +910,8 @@ overmap_path_params overmap_path_params::for_aircraft()
     return ret;
 }
 
-static int get_terrain_cost( const tripoint_abs_omt &omt_pos, const overmap_path_params &params )
+static int get_terrain_cost( const oter_id &oter, const overmap_path_params &params )
 {
-    if( params.only_known_by_player && !overmap_buffer.seen( omt_pos ) ) {
-        return -1;
-    }
-    if( params.avoid_danger && overmap_buffer.is_marked_dangerous( omt_pos ) ) {
-        return -1;
-    }
-    const oter_id &oter = overmap_buffer.ter_existing( omt_pos );
     if( is_ot_match( "road", oter, ot_match_type::type ) ||
         is_ot_match( "bridge", oter, ot_match_type::type ) ||
         is_ot_match( "bridge_road", oter, ot_match_type::type ) ||
@@ -814,13 +954,39 @@ static int get_terrain_cost( const tripoint_abs_omt &omt_pos, const overmap_path
     }
 }
 
-static bool is_ramp( const tripoint_abs_omt &omt_pos )
+static bool is_ramp( const oter_id &oter )
 {
-    const oter_id &oter = overmap_buffer.ter_existing( omt_pos );
     return is_ot_match( "bridgehead_ground", oter, ot_match_type::type ) ||
            is_ot_match( "bridgehead_ramp", oter, ot_match_type::type );
 }
 
+namespace
+{
+
+// Scores of the overmap terrain types for one kind of travel, worked out the first time each is met
+class terrain_scores
+{
+    public:
+        explicit terrain_scores( const overmap_path_params &params ) : params( params ) {}
+
+        pf::omt_score operator()( const oter_id &oter ) {
+            const size_t i = oter.to_i();
+            if( i >= scores.size() ) {
+                scores.resize( i + 1 );
+            }
+            if( !scores[i] ) {
+                scores[i] = pf::omt_score( get_terrain_cost( oter, params ), is_ramp( oter ) );
+            }
+            return *scores[i];
+        }
+
+    private:
+        const overmap_path_params &params;
+        std::vector<cata::optional<pf::omt_score>> scores;
+};
+
+} // namespace
+
 std::vector<tripoint_abs_omt> overmapbuffer::get_travel_path(
     const tripoint_abs_omt &src, const tripoint_abs_omt &dest, overmap_path_params params )
 {
@@ -828,16 +994,48 @@ std::vector<tripoint_abs_omt> overmapbuffer::get_travel_path(
         return {};
     }
 
-    const pf::omt_scoring_fn estimate = [&]( tripoint_abs_omt pos ) {
-        const int cur_cost = pos == src ? 0 : get_terrain_cost( pos, params );
-        if( cur_cost < 0 ) {
+    // Whether a tile was seen or is near a dangerous note can change without its terrain changing
+    const bool cacheable = !params.only_known_by_player && !params.avoid_danger;
+    if( cacheable ) {
+        if( travel_paths_revision != overmap::terrain_revision ) {
+            travel_paths.clear();
+            next_travel_path = 0;
+            travel_paths_revision = overmap::terrain_revision;
+        }
+        for( const travel_path &known : travel_paths ) {
+            if( known.src == src && known.dest == dest && known.params == params ) {
+                return known.points;
+            }
+        }
+    }
+
+    terrain_scores scores( params );
+    const auto estimate = [&]( const tripoint_abs_omt & pos ) {
+        if( pos == src ) {
+            return pf::omt_score( 0, scores( ter_existing( pos ) ).allow_z_change );
+        }
+        if( params.only_known_by_player && !seen( pos ) ) {
+            return pf::omt_score::rejected;
+        }
+        if( params.avoid_danger && is_marked_dangerous( pos ) ) {
             return pf::omt_score::rejected;
         }
-        return pf::omt_score( cur_cost, is_ramp( pos ) );
+        return scores( ter_existing( pos ) );
     };
 
     constexpr int radius = 4 * OMAPX; // radius of search in OMTs = 4 overmaps
     const pf::simple_path<tripoint_abs_omt> path = pf::find_overmap_path( src, dest, radius, estimate );
+    // Generating terrain while searching is not expected, but would make the route outdated
+    if( cacheable && travel_paths_revision == overmap::terrain_revision ) {
+        constexpr size_t max_travel_paths = 64;
+        travel_path found{ src, dest, params, path.points };
+        if( travel_paths.size() < max_travel_paths ) {
+            travel_paths.push_back( std::move( found ) );
+        } else {
+            travel_paths[next_travel_path] = std::move( found );
+            next_travel_path = ( next_travel_path + 1 ) % max_travel_paths;
+        }
+    }
     return path.points;
 }
 
@@ -4,10 +4,18 @@
 
 #include <array>
 #include <functional>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+
+#if defined(_WIN32) && !defined(_MSC_VER) && !defined(_GLIBCXX_HAS_GTHREADS)
+// MinGW without gthreads has no std::future, overmaps are read ahead on the main thread
+#   define OVERMAP_READ_AHEAD_SYNC
+#else
+#   include <future>
+#endif
 #include <utility>
 #include <vector>
 
@@ -56,6 +64,7 @@ struct overmap_path_params {
     bool only_known_by_player = true;
 
     static constexpr int standard_cost = 10;
+    bool operator==( const overmap_path_params &rhs ) const;
     static overmap_path_params for_player();
     static overmap_path_params for_npc();
     static overmap_path_params for_land_vehicle( float offroad_coeff, bool tiny, bool amphibious );
@@ -107,6 +116,22 @@ struct camp_reference {
     int get_distance_from_bounds() const;
 };
 
+/**
+ * Raw contents of the save files of a single overmap, read ahead of time so
+ * that loading the overmap does not have to wait on disk access.
+ */
+struct overmap_file_contents {
+    std::string terrain;
+    /** Per-player view data, empty if there is no such file. */
+    std::string view;
+};
+
+#if defined(OVERMAP_READ_AHEAD_SYNC)
+using pending_overmap_load = cata::optional<overmap_file_contents>;
+#else
+using pending_overmap_load = std::future<cata::optional<overmap_file_contents>>;
+#endif
+
 struct overmap_with_local_coords {
     overmap *om;
     tripoint_om_omt local;
@@ -177,6 +202,16 @@ class overmapbuffer
         void save();
         void clear();
         void create_custom_overmap( const point_abs_om &, overmap_special_batch &specials );
+        /**
+         * Prepares the overmaps next to the given position ahead of time, so that
+         * crossing into them does not stall the game.
+         * Only does something if @p p is within @ref overmap_prepare_distance overmap
+         * terrain tiles of an edge of its overmap. Neighbours that exist on disk
+         * are read by a background worker. Missing ones are generated right here on
+         * the calling thread, at most one per call, so generation still takes as
+         * long as before, it just happens before the player gets there.
+         */
+        void prepare_neighbors( const tripoint_abs_omt &p );
 
         /**
          * Returns the overmap terrain at the given OMT coordinates.
@@ -364,6 +399,11 @@ class overmapbuffer
         bool reveal( const tripoint_abs_omt &center, int radius );
         bool reveal( const tripoint_abs_omt &center, int radius,
                      const std::function<bool( const oter_id & )> &filter );
+        /**
+         * Finds the cheapest route between two places for the given kind of travel.
+         * Routes that don't depend on what the player has seen or marked as dangerous are
+         * remembered until the overmap terrain changes, as NPCs keep asking for the same ones.
+         */
         std::vector<tripoint_abs_omt> get_travel_path(
             const tripoint_abs_omt &src, const tripoint_abs_omt &dest, overmap_path_params params );
         bool reveal_route( const tripoint_abs_omt &source, const tripoint_abs_omt &dest,
@@ -537,6 +577,31 @@ class overmapbuffer
         mutable std::set<point_abs_om> known_non_existing;
         // Cached result of previous call to overmapbuffer::get_existing
         overmap mutable *last_requested_overmap;
+        /** A route found by @ref get_travel_path */
+        struct travel_path {
+            tripoint_abs_omt src;
+            tripoint_abs_omt dest;
+            overmap_path_params params;
+            std::vector<tripoint_abs_omt> points;
+        };
+        /** Recent routes, valid while @ref overmap::terrain_revision is travel_paths_revision */
+        std::vector<travel_path> travel_paths;
+        unsigned travel_paths_revision = 0;
+        /** Where the next route goes once the list is full, replacing the oldest one */
+        size_t next_travel_path = 0;
+        /**
+         * Save files that are being read in the background, see @ref prepare_neighbors.
+         * A future yields nothing if the files could not be read, in which case
+         * the overmap is loaded the usual way.
+         */
+        std::map<point_abs_om, pending_overmap_load> pending_loads;
+        /** Starts reading the save files of the given overmap in the background. */
+        void request_load( const point_abs_om &p );
+        /**
+         * Removes the background read of the given overmap, waiting for it
+         * to finish if necessary. Returns the contents if it succeeded.
+         */
+        cata::optional<overmap_file_contents> take_pending_load( const point_abs_om &p );
 
         /**
          * Get a list of notes in the (loaded) overmaps.
@@ -1,14 +1,17 @@
 #include "pathfinding.h"
 
+#include <climits>
 #include <cstdlib>
 #include <algorithm>
-#include <queue>
 #include <set>
 #include <array>
+#include <iterator>
 #include <memory>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "calendar.h"
 #include "cata_utility.h"
 #include "coordinates.h"
 #include "debug.h"
@@ -21,10 +24,14 @@
 #include "vehicle.h"
 #include "vpart_position.h"
 #include "line.h"
+#include "map_iterator.h"
 #include "type_id.h"
 #include "point.h"
 
-enum astar_state {
+// Tiles that aren't plain flat ground as far as pathfinding is concerned
+static const pf_special non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
+
+enum astar_state : unsigned char {
     ASL_NONE,
     ASL_OPEN,
     ASL_CLOSED
@@ -36,82 +43,170 @@ constexpr int flat_index( const tripoint &p )
     return ( p.x * MAPSIZE_Y ) + p.y;
 }
 
+constexpr int layer_size = MAPSIZE_X * MAPSIZE_Y;
+
+// Turns a point into an index unique across all z-levels
+constexpr int node_index( const tripoint &p )
+{
+    return ( p.z + OVERMAP_DEPTH ) * layer_size + flat_index( p );
+}
+
+static tripoint node_point( const int index )
+{
+    const int flat = index % layer_size;
+    return tripoint( flat / MAPSIZE_Y, flat % MAPSIZE_Y, index / layer_size - OVERMAP_DEPTH );
+}
+
+struct path_node {
+    // Search that last wrote this node, nodes of older searches read as unvisited
+    unsigned generation = 0;
+    astar_state state = ASL_NONE;
+    int gscore = 0;
+    int score = 0;
+    // See node_index
+    int parent = 0;
+};
+
 // Flattened 2D array representing a single z-level worth of pathfinding data
+// Layers are kept between searches, so nothing has to be cleared when a new one starts.
 struct path_data_layer {
-    // State is accessed way more often than all other values here
-    std::array< astar_state, MAPSIZE_X *MAPSIZE_Y > state;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > score;
-    std::array< int, MAPSIZE_X *MAPSIZE_Y > gscore;
-    std::array< tripoint, MAPSIZE_X *MAPSIZE_Y > parent;
+    std::array< path_node, layer_size > nodes;
+    unsigned generation = 0;
+
+    path_node &at( const int index ) {
+        path_node &node = nodes[index];
+        if( node.generation != generation ) {
+            node = path_node();
+            node.generation = generation;
+        }
+        return node;
+    }
+};
+
+// Open list for small non-negative integer scores: one bucket of points per score.
+// Scores lower than the current minimum may still be pushed, they just move the cursor back.
+class bucket_queue
+{
+    public:
+        bool empty() const {
+            return count == 0;
+        }
 
-    void init( const point &min, const point &max ) {
-        tripoint p;
-        for( p.x = min.x; p.x <= max.x; p.x++ ) {
-            for( p.y = min.y; p.y <= max.y; p.y++ ) {
-                const int ind = flat_index( p );
-                state[ind] = ASL_NONE; // Mark as unvisited
+        void push( const int score, const tripoint &p ) {
+            const size_t bucket = std::max( score, 0 );
+            if( bucket >= buckets.size() ) {
+                buckets.resize( bucket + 1 );
             }
+            buckets[bucket].push_back( p );
+            first = std::min( first, bucket );
+            last = std::max( last, bucket );
+            count++;
         }
-    }
+
+        tripoint pop() {
+            while( buckets[first].empty() ) {
+                first++;
+            }
+            const tripoint p = buckets[first].back();
+            buckets[first].pop_back();
+            count--;
+            return p;
+        }
+
+        void clear() {
+            for( size_t i = first; i <= last && i < buckets.size(); i++ ) {
+                buckets[i].clear();
+            }
+            first = buckets.size();
+            last = 0;
+            count = 0;
+        }
+
+    private:
+        // Buckets keep their capacity between searches
+        std::vector<std::vector<tripoint>> buckets;
+        // No bucket below first holds anything, no bucket above last does either
+        size_t first = 0;
+        size_t last = 0;
+        size_t count = 0;
+};
+
+// State of the searches of one thread, reused by all of them
+struct pathfinding_arena {
+    std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
+    bucket_queue open;
+    unsigned generation = 0;
 };
 
+static pathfinding_arena &get_pathfinding_arena()
+{
+    thread_local pathfinding_arena arena;
+    return arena;
+}
+
 struct pathfinder {
-    point min;
-    point max;
-    pathfinder( const point &_min, const point &_max ) :
-        min( _min ), max( _max ) {
+    pathfinding_arena &arena;
+
+    pathfinder() : arena( get_pathfinding_arena() ) {
+        arena.open.clear();
+        arena.generation++;
+        if( arena.generation == 0 ) {
+            // Wrapped around, nodes from long ago could pass as current ones
+            for( std::unique_ptr< path_data_layer > &layer : arena.path_data ) {
+                if( layer != nullptr ) {
+                    for( path_node &node : layer->nodes ) {
+                        node.generation = 0;
+                    }
+                }
+            }
+            arena.generation = 1;
+        }
     }
 
-    std::priority_queue< std::pair<int, tripoint>, std::vector< std::pair<int, tripoint> >, pair_greater_cmp_first >
-    open;
-    std::array< std::unique_ptr< path_data_layer >, OVERMAP_LAYERS > path_data;
-
     path_data_layer &get_layer( const int z ) {
-        std::unique_ptr< path_data_layer > &ptr = path_data[z + OVERMAP_DEPTH];
-        if( ptr != nullptr ) {
-            return *ptr;
+        std::unique_ptr< path_data_layer > &ptr = arena.path_data[z + OVERMAP_DEPTH];
+        if( ptr == nullptr ) {
+            ptr = std::make_unique<path_data_layer>();
         }
-
-        ptr = std::make_unique<path_data_layer>();
-        ptr->init( min, max );
+        ptr->generation = arena.generation;
         return *ptr;
     }
 
+    path_node &node( const tripoint &p ) {
+        return get_layer( p.z ).at( flat_index( p ) );
+    }
+
     bool empty() const {
-        return open.empty();
+        return arena.open.empty();
     }
 
     tripoint get_next() {
-        const auto pt = open.top();
-        open.pop();
-        return pt.second;
+        return arena.open.pop();
     }
 
     void add_point( const int gscore, const int score, const tripoint &from, const tripoint &to ) {
-        auto &layer = get_layer( to.z );
-        const int index = flat_index( to );
-        if( ( layer.state[index] == ASL_OPEN && gscore >= layer.gscore[index] ) ||
-            layer.state[index] == ASL_CLOSED ) {
+        if( to.x < 0 || to.x >= MAPSIZE_X || to.y < 0 || to.y >= MAPSIZE_Y ) {
+            return;
+        }
+        path_node &next = node( to );
+        if( ( next.state == ASL_OPEN && gscore >= next.gscore ) ||
+            next.state == ASL_CLOSED ) {
             return;
         }
 
-        layer.state [index] = ASL_OPEN;
-        layer.gscore[index] = gscore;
-        layer.parent[index] = from;
-        layer.score [index] = score;
-        open.push( std::make_pair( score, to ) );
+        next.state = ASL_OPEN;
+        next.gscore = gscore;
+        next.parent = node_index( from );
+        next.score = score;
+        arena.open.push( score, to );
     }
 
     void close_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p );
-        layer.state[index] = ASL_CLOSED;
+        node( p ).state = ASL_CLOSED;
     }
 
     void unclose_point( const tripoint &p ) {
-        auto &layer = get_layer( p.z );
-        const int index = flat_index( p );
-        layer.state[index] = ASL_NONE;
+        node( p ).state = ASL_NONE;
     }
 };
 
@@ -191,6 +286,167 @@ bool is_disjoint( const Set1 &set1, const Set2 &set2 )
     return true;
 }
 
+// The straight line from f to t on the same z-level, if it only crosses flat ground.
+// Except when the line contains a pre-closed tile - we need to do regular pathing then
+static std::vector<tripoint> straight_route( const map &m, const tripoint &f, const tripoint &t,
+        const std::set<tripoint> &pre_closed )
+{
+    std::vector<tripoint> line_path = line_to( f, t );
+    const auto &pf_cache = m.get_pathfinding_cache_ref( f.z );
+    // Check all points for any special case (including just hard terrain)
+    if( !( pf_cache.special[f.x][f.y] & non_normal ) &&
+    std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
+    return !( pf_cache.special[p.x][p.y] & non_normal );
+    } ) ) {
+        const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
+
+        if( is_disjoint( sorted_line, pre_closed ) ) {
+            return line_path;
+        }
+    }
+    return std::vector<tripoint>();
+}
+
+int map::pathfinding_step_cost( const tripoint &from, const tripoint &to,
+                                const pathfinding_settings &settings, const pathfinding_cache &pf_cache,
+                                const vehicle *from_veh ) const
+{
+    const int bash = settings.bash_strength;
+    const int climb_cost = settings.climb_cost;
+    const bool doors = settings.allow_open_doors;
+    const bool trapavoid = settings.avoid_traps;
+    const bool roughavoid = settings.avoid_rough_terrain;
+    const bool sharpavoid = settings.avoid_sharp;
+
+    int part = -1;
+    const vehicle *veh = veh_at_internal( to, part );
+    if( from_veh &&
+        !from_veh->allowed_move( from_veh->tripoint_to_mount( from ), from_veh->tripoint_to_mount( to ) ) ) {
+        //Trying to squeeze through a vehicle hole, skip this movement but don't close the tile as other paths may lead to it
+        return PF_STEP_SKIP;
+    }
+
+    if( veh && veh != from_veh &&
+        !veh->allowed_move( veh->tripoint_to_mount( from ), veh->tripoint_to_mount( to ) ) ) {
+        //Same as above but moving into rather than out of a vehicle
+        return PF_STEP_SKIP;
+    }
+
+    // Penalize for diagonals or the path will look "unnatural"
+    int step = ( from.x != to.x && from.y != to.y ) ? 1 : 0;
+
+    const auto to_special = pf_cache.special[to.x][to.y];
+    // TODO: De-uglify, de-huge-n
+    if( !( to_special & non_normal ) ) {
+        // Boring flat dirt - the most common case above the ground
+        return step + 2;
+    }
+
+    if( roughavoid ) {
+        // Close all rough terrain tiles
+        return PF_STEP_CLOSED;
+    }
+
+    const maptile &tile = maptile_at_internal( to );
+    const auto &terrain = tile.get_ter_t();
+    const auto &furniture = tile.get_furn_t();
+
+    const int cost = move_cost_internal( furniture, terrain, veh, part );
+    // Don't calculate bash rating unless we intend to actually use it
+    const int rating = ( bash == 0 || cost != 0 ) ? -1 :
+                       bash_rating_internal( bash, furniture, terrain, false, veh, part );
+
+    if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
+        climb_cost <= 0 ) {
+        return PF_STEP_CLOSED;
+    }
+
+    step += cost;
+    if( cost == 0 ) {
+        if( climb_cost > 0 && to_special & PF_CLIMBABLE ) {
+            // Climbing fences
+            step += climb_cost;
+        } else if( doors && ( terrain.open || furniture.open ) &&
+                   ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
+                     !is_outside( from ) ) ) {
+            // Only try to open INSIDE doors from the inside
+            // To open and then move onto the tile
+            step += 4;
+        } else if( veh != nullptr ) {
+            const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
+            part = vpobst ? vpobst->part_index() : -1;
+            if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
+                ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) || from_veh == veh ) ) {
+                // Handle car doors, but don't try to path through curtains
+                step += 10; // One turn to open, 4 to move there
+            } else if( part >= 0 && bash > 0 ) {
+                // Car obstacle that isn't a door
+                // TODO: Account for armor
+                int hp = veh->cpart( part ).hp();
+                if( hp / 20 > bash ) {
+                    // Threshold damage thing means we just can't bash this down
+                    return PF_STEP_CLOSED;
+                } else if( hp / 10 > bash ) {
+                    // Threshold damage thing means we will fail to deal damage pretty often
+                    hp *= 2;
+                }
+
+                step += 2 * hp / bash + 8 + 4;
+            } else if( part >= 0 ) {
+                if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
+                    // Won't be openable, don't try from other sides
+                    return PF_STEP_CLOSED;
+                }
+
+                return PF_STEP_SKIP;
+            }
+        } else if( rating > 1 ) {
+            // Expected number of turns to bash it down, 1 turn to move there
+            // and 5 turns of penalty not to trash everything just because we can
+            step += ( 20 / rating ) + 2 + 10;
+        } else if( rating == 1 ) {
+            // Desperate measures, avoid whenever possible
+            step += 500;
+        } else {
+            // Unbashable and unopenable from here
+            if( !doors || !terrain.open || !furniture.open ) {
+                // Or anywhere else for that matter
+                return PF_STEP_CLOSED;
+            }
+
+            return PF_STEP_SKIP;
+        }
+    }
+
+    if( trapavoid && to_special & PF_TRAP ) {
+        const auto &ter_trp = terrain.trap.obj();
+        const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
+        if( !trp.is_benign() ) {
+            // For now make them detect all traps
+            if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
+                // Special case - ledge in z-levels
+                // Warning: really expensive, needs a cache
+                if( valid_move( to, tripoint( to.xy(), to.z - 1 ), false, true ) ) {
+                    return PF_STEP_LEDGE;
+                }
+            } else if( trapavoid ) {
+                // Otherwise it's walkable
+                step += 500;
+            }
+        }
+    }
+
+    if( sharpavoid && to_special & PF_SHARP ) {
+        // Avoid sharp things
+        return PF_STEP_CLOSED;
+    }
+
+    return step;
+}
+
+// Routes at least this long are planned on the portal graph first
+static constexpr int portal_route_min_dist = SEEX * 2;
+
 std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                                   const pathfinding_settings &settings,
                                   const std::set<tripoint> &pre_closed ) const
@@ -210,21 +466,10 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return route( f, clipped, settings, pre_closed );
     }
     // First, check for a simple straight line on flat ground
-    // Except when the line contains a pre-closed tile - we need to do regular pathing then
-    static const auto non_normal = PF_SLOW | PF_WALL | PF_VEHICLE | PF_TRAP | PF_SHARP;
     if( f.z == t.z ) {
-        const auto line_path = line_to( f, t );
-        const auto &pf_cache = get_pathfinding_cache_ref( f.z );
-        // Check all points for any special case (including just hard terrain)
-        if( !( pf_cache.special[f.x][f.y] & non_normal ) &&
-        std::all_of( line_path.begin(), line_path.end(), [&pf_cache]( const tripoint & p ) {
-        return !( pf_cache.special[p.x][p.y] & non_normal );
-        } ) ) {
-            const std::set<tripoint> sorted_line( line_path.begin(), line_path.end() );
-
-            if( is_disjoint( sorted_line, pre_closed ) ) {
-                return line_path;
-            }
+        std::vector<tripoint> line_path = straight_route( *this, f, t, pre_closed );
+        if( !line_path.empty() ) {
+            return line_path;
         }
     }
 
@@ -233,13 +478,48 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         return ret;
     }
 
+    if( square_dist( f, t ) >= portal_route_min_dist ) {
+        ret = route_through_portals( f, t, settings, pre_closed );
+        if( !ret.empty() ) {
+            return ret;
+        }
+    }
+
+    return route_locally( f, t, settings, pre_closed );
+}
+
+std::vector<tripoint> map::route_through_portals( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const
+{
+    if( path_portals == nullptr ) {
+        path_portals = std::make_unique<portal_graph>();
+    }
+    std::vector<tripoint> ret;
+    tripoint cur = f;
+    for( const tripoint &next : path_portals->find_route( *this, f, t, settings.max_length,
+            pre_closed ) ) {
+        std::vector<tripoint> leg;
+        if( cur.z == next.z ) {
+            leg = straight_route( *this, cur, next, pre_closed );
+        }
+        if( leg.empty() ) {
+            leg = route_locally( cur, next, settings, pre_closed );
+        }
+        if( leg.empty() ) {
+            // The graph was too optimistic, like about a door these settings don't open
+            return leg;
+        }
+        ret.insert( ret.end(), leg.begin(), leg.end() );
+        cur = next;
+    }
+    return ret;
+}
+
+std::vector<tripoint> map::route_locally( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings, const std::set<tripoint> &pre_closed ) const
+{
+    std::vector<tripoint> ret;
     int max_length = settings.max_length;
-    int bash = settings.bash_strength;
-    int climb_cost = settings.climb_cost;
-    bool doors = settings.allow_open_doors;
-    bool trapavoid = settings.avoid_traps;
-    bool roughavoid = settings.avoid_rough_terrain;
-    bool sharpavoid = settings.avoid_sharp;
 
     const int pad = 16;  // Should be much bigger - low value makes pathfinders dumb!
     int minx = std::min( f.x, t.x ) - pad;
@@ -253,7 +533,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
     clip_to_bounds( minx, miny, minz );
     clip_to_bounds( maxx, maxy, maxz );
 
-    pathfinder pf( point( minx, miny ), point( maxx, maxy ) );
+    pathfinder pf;
     // Make NPCs not want to path through player
     // But don't make player pathing stop working
     for( const auto &p : pre_closed ) {
@@ -274,12 +554,12 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
         const int parent_index = flat_index( cur );
         auto &layer = pf.get_layer( cur.z );
-        auto &cur_state = layer.state[parent_index];
-        if( cur_state == ASL_CLOSED ) {
+        path_node &cur_node = layer.at( parent_index );
+        if( cur_node.state == ASL_CLOSED ) {
             continue;
         }
 
-        if( layer.gscore[parent_index] > max_length ) {
+        if( cur_node.gscore > max_length ) {
             // Shortest path would be too long, return empty vector
             return std::vector<tripoint>();
         }
@@ -289,7 +569,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             break;
         }
 
-        cur_state = ASL_CLOSED;
+        cur_node.state = ASL_CLOSED;
 
         const auto &pf_cache = get_pathfinding_cache_ref( cur.z );
         const auto cur_special = pf_cache.special[cur.x][cur.y];
@@ -311,152 +591,36 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
                 continue;
             }
 
-            if( layer.state[index] == ASL_CLOSED ) {
+            path_node &next = layer.at( index );
+            if( next.state == ASL_CLOSED ) {
                 continue;
             }
 
-            int part = -1;
-            const vehicle *veh = veh_at_internal( p, part );
-            if( cur_veh &&
-                !cur_veh->allowed_move( cur_veh->tripoint_to_mount( cur ), cur_veh->tripoint_to_mount( p ) ) ) {
-                //Trying to squeeze through a vehicle hole, skip this movement but don't close the tile as other paths may lead to it
+            const int step = pathfinding_step_cost( cur, p, settings, pf_cache, cur_veh );
+            if( step == PF_STEP_SKIP ) {
                 continue;
             }
-
-            if( veh && veh != cur_veh &&
-                !veh->allowed_move( veh->tripoint_to_mount( cur ), veh->tripoint_to_mount( p ) ) ) {
-                //Same as above but moving into rather than out of a vehicle
-                continue;
-            }
-
-            // Penalize for diagonals or the path will look "unnatural"
-            int newg = layer.gscore[parent_index] + ( ( cur.x != p.x && cur.y != p.y ) ? 1 : 0 );
-
-            const auto p_special = pf_cache.special[p.x][p.y];
-            // TODO: De-uglify, de-huge-n
-            if( !( p_special & non_normal ) ) {
-                // Boring flat dirt - the most common case above the ground
-                newg += 2;
-            } else {
-                if( roughavoid ) {
-                    layer.state[index] = ASL_CLOSED; // Close all rough terrain tiles
-                    continue;
-                }
-
-                const maptile &tile = maptile_at_internal( p );
-                const auto &terrain = tile.get_ter_t();
-                const auto &furniture = tile.get_furn_t();
-
-                const int cost = move_cost_internal( furniture, terrain, veh, part );
-                // Don't calculate bash rating unless we intend to actually use it
-                const int rating = ( bash == 0 || cost != 0 ) ? -1 :
-                                   bash_rating_internal( bash, furniture, terrain, false, veh, part );
-
-                if( cost == 0 && rating <= 0 && ( !doors || !terrain.open || !furniture.open ) && veh == nullptr &&
-                    climb_cost <= 0 ) {
-                    layer.state[index] = ASL_CLOSED; // Close it so that next time we won't try to calculate costs
-                    continue;
-                }
-
-                newg += cost;
-                if( cost == 0 ) {
-                    if( climb_cost > 0 && p_special & PF_CLIMBABLE ) {
-                        // Climbing fences
-                        newg += climb_cost;
-                    } else if( doors && ( terrain.open || furniture.open ) &&
-                               ( !terrain.has_flag( "OPENCLOSE_INSIDE" ) || !furniture.has_flag( "OPENCLOSE_INSIDE" ) ||
-                                 !is_outside( cur ) ) ) {
-                        // Only try to open INSIDE doors from the inside
-                        // To open and then move onto the tile
-                        newg += 4;
-                    } else if( veh != nullptr ) {
-                        const auto vpobst = vpart_position( const_cast<vehicle &>( *veh ), part ).obstacle_at_part();
-                        part = vpobst ? vpobst->part_index() : -1;
-                        int dummy = -1;
-                        if( doors && veh->part_flag( part, VPFLAG_OPENABLE ) &&
-                            ( !veh->part_flag( part, "OPENCLOSE_INSIDE" ) ||
-                              veh_at_internal( cur, dummy ) == veh ) ) {
-                            // Handle car doors, but don't try to path through curtains
-                            newg += 10; // One turn to open, 4 to move there
-                        } else if( part >= 0 && bash > 0 ) {
-                            // Car obstacle that isn't a door
-                            // TODO: Account for armor
-                            int hp = veh->cpart( part ).hp();
-                            if( hp / 20 > bash ) {
-                                // Threshold damage thing means we just can't bash this down
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            } else if( hp / 10 > bash ) {
-                                // Threshold damage thing means we will fail to deal damage pretty often
-                                hp *= 2;
-                            }
-
-                            newg += 2 * hp / bash + 8 + 4;
-                        } else if( part >= 0 ) {
-                            if( !doors || !veh->part_flag( part, VPFLAG_OPENABLE ) ) {
-                                // Won't be openable, don't try from other sides
-                                layer.state[index] = ASL_CLOSED;
-                            }
-
-                            continue;
-                        }
-                    } else if( rating > 1 ) {
-                        // Expected number of turns to bash it down, 1 turn to move there
-                        // and 5 turns of penalty not to trash everything just because we can
-                        newg += ( 20 / rating ) + 2 + 10;
-                    } else if( rating == 1 ) {
-                        // Desperate measures, avoid whenever possible
-                        newg += 500;
-                    } else {
-                        // Unbashable and unopenable from here
-                        if( !doors || !terrain.open || !furniture.open ) {
-                            // Or anywhere else for that matter
-                            layer.state[index] = ASL_CLOSED;
-                        }
-
-                        continue;
-                    }
+            if( step == PF_STEP_LEDGE ) {
+                tripoint below( p.xy(), p.z - 1 );
+                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
+                    // Otherwise this would have been a huge fall
+                    auto &layer = pf.get_layer( p.z - 1 );
+                    // From cur, not p, because we won't be walking on air
+                    pf.add_point( layer.at( parent_index ).gscore + 10,
+                                  layer.at( parent_index ).score + 10 + 2 * rl_dist( below, t ),
+                                  cur, below );
                 }
-
-                if( trapavoid && p_special & PF_TRAP ) {
-                    const auto &ter_trp = terrain.trap.obj();
-                    const auto &trp = ter_trp.is_benign() ? tile.get_trap_t() : ter_trp;
-                    if( !trp.is_benign() ) {
-                        // For now make them detect all traps
-                        if( has_zlevels() && terrain.has_flag( TFLAG_NO_FLOOR ) ) {
-                            // Special case - ledge in z-levels
-                            // Warning: really expensive, needs a cache
-                            if( valid_move( p, tripoint( p.xy(), p.z - 1 ), false, true ) ) {
-                                tripoint below( p.xy(), p.z - 1 );
-                                if( !has_flag( TFLAG_NO_FLOOR, below ) ) {
-                                    // Otherwise this would have been a huge fall
-                                    auto &layer = pf.get_layer( p.z - 1 );
-                                    // From cur, not p, because we won't be walking on air
-                                    pf.add_point( layer.gscore[parent_index] + 10,
-                                                  layer.score[parent_index] + 10 + 2 * rl_dist( below, t ),
-                                                  cur, below );
-                                }
-
-                                // Close p, because we won't be walking on it
-                                layer.state[index] = ASL_CLOSED;
-                                continue;
-                            }
-                        } else if( trapavoid ) {
-                            // Otherwise it's walkable
-                            newg += 500;
-                        }
-                    }
-                }
-
-                if( sharpavoid && p_special & PF_SHARP ) {
-                    layer.state[index] = ASL_CLOSED; // Avoid sharp things
-                }
-
             }
+            if( step < 0 ) {
+                // Close it so that next time we won't try to calculate costs
+                next.state = ASL_CLOSED;
+                continue;
+            }
+            const int newg = cur_node.gscore + step;
 
             // If not visited, add as open
             // If visited, add it only if we can do so with better score
-            if( layer.state[index] == ASL_NONE || newg < layer.gscore[index] ) {
+            if( next.state == ASL_NONE || newg < next.gscore ) {
                 pf.add_point( newg, newg + 2 * rl_dist( p, t ), cur, p );
             }
         }
@@ -472,8 +636,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z - 1 );
             if( vertical_move_destination<TFLAG_GOES_UP>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.at( parent_index ).gscore + 2,
+                              layer.at( parent_index ).score + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -481,8 +645,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             tripoint dest( cur.xy(), cur.z + 1 );
             if( vertical_move_destination<TFLAG_GOES_DOWN>( *this, dest ) ) {
                 auto &layer = pf.get_layer( dest.z );
-                pf.add_point( layer.gscore[parent_index] + 2,
-                              layer.score[parent_index] + 2 * rl_dist( dest, t ),
+                pf.add_point( layer.at( parent_index ).gscore + 2,
+                              layer.at( parent_index ).score + 2 * rl_dist( dest, t ),
                               cur, dest );
             }
         }
@@ -491,8 +655,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( layer.at( parent_index ).gscore + 4,
+                              layer.at( parent_index ).score + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -501,8 +665,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z + 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint above( cur.x + x_offset[it], cur.y + y_offset[it], cur.z + 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( above, t ),
+                pf.add_point( layer.at( parent_index ).gscore + 4,
+                              layer.at( parent_index ).score + 4 + 2 * rl_dist( above, t ),
                               cur, above );
             }
         }
@@ -511,8 +675,8 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
             auto &layer = pf.get_layer( cur.z - 1 );
             for( size_t it = 0; it < 8; it++ ) {
                 const tripoint below( cur.x + x_offset[it], cur.y + y_offset[it], cur.z - 1 );
-                pf.add_point( layer.gscore[parent_index] + 4,
-                              layer.score[parent_index] + 4 + 2 * rl_dist( below, t ),
+                pf.add_point( layer.at( parent_index ).gscore + 4,
+                              layer.at( parent_index ).score + 4 + 2 * rl_dist( below, t ),
                               cur, below );
             }
         }
@@ -524,9 +688,7 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
         tripoint cur = t;
         // Just to limit max distance, in case something weird happens
         for( int fdist = max_length; fdist != 0; fdist-- ) {
-            const int cur_index = flat_index( cur );
-            const auto &layer = pf.get_layer( cur.z );
-            const tripoint &par = layer.parent[cur_index];
+            const tripoint par = node_point( pf.node( cur ).parent );
             if( cur == f ) {
                 break;
             }
@@ -548,3 +710,599 @@ std::vector<tripoint> map::route( const tripoint &f, const tripoint &t,
 
     return ret;
 }
+
+// Fields kept around for route_to_shared_target, enough for a few targets and monster kinds
+static constexpr size_t max_flow_fields = 8;
+
+const flow_field &map::get_flow_field( const tripoint &t,
+                                       const pathfinding_settings &settings ) const
+{
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( t.z );
+    const auto is_current = [this]( const flow_field & field ) {
+        const pathfinding_cache &cache = get_pathfinding_cache( field.target.z );
+        return field.turn == calendar::turn && !cache.dirty &&
+               field.cache_generation == cache.generation;
+    };
+    for( const std::unique_ptr<flow_field> &field : flow_fields ) {
+        if( field->target == t && field->settings == settings && is_current( *field ) ) {
+            return *field;
+        }
+    }
+
+    // Outdated fields go first, then the oldest one
+    flow_fields.erase( std::remove_if( flow_fields.begin(), flow_fields.end(),
+    [&]( const std::unique_ptr<flow_field> &field ) {
+        return !is_current( *field );
+    } ), flow_fields.end() );
+    if( flow_fields.size() >= max_flow_fields ) {
+        flow_fields.erase( flow_fields.begin() );
+    }
+    flow_fields.emplace_back( std::make_unique<flow_field>() );
+    flow_field &field = *flow_fields.back();
+    field.target = t;
+    field.settings = settings;
+    field.turn = calendar::turn;
+    field.cache_generation = pf_cache.generation;
+    field.cost.fill( INT_MAX );
+
+    // Dijkstra from the target, over the steps leading into each tile
+    std::vector<bool> settled( layer_size, false );
+    bucket_queue open;
+    field.cost[flat_index( t )] = 0;
+    open.push( 0, t );
+    while( !open.empty() ) {
+        const tripoint cur = open.pop();
+        const int cur_index = flat_index( cur );
+        if( settled[cur_index] ) {
+            continue;
+        }
+        settled[cur_index] = true;
+        const int cur_cost = field.cost[cur_index];
+        if( cur_cost > settings.max_length ) {
+            break;
+        }
+
+        for( const tripoint &p : points_in_radius( cur, 1 ) ) {
+            if( !inbounds( p ) ) {
+                continue;
+            }
+            const int index = flat_index( p );
+            if( settled[index] ) {
+                continue;
+            }
+            int part = -1;
+            const int step = pathfinding_step_cost( p, cur, settings, pf_cache, veh_at_internal( p, part ) );
+            if( step < 0 ) {
+                continue;
+            }
+            if( cur_cost + step < field.cost[index] ) {
+                field.cost[index] = cur_cost + step;
+                open.push( cur_cost + step, p );
+            }
+        }
+    }
+    return field;
+}
+
+std::vector<tripoint> map::route_to_shared_target( const tripoint &f, const tripoint &t,
+        const pathfinding_settings &settings ) const
+{
+    if( f == t || f.z != t.z || !inbounds( f ) || !inbounds( t ) ||
+        rl_dist( f, t ) > settings.max_dist ) {
+        return route( f, t, settings );
+    }
+    std::vector<tripoint> ret = straight_route( *this, f, t, {} );
+    if( !ret.empty() ) {
+        return ret;
+    }
+
+    const flow_field &field = get_flow_field( t, settings );
+    if( field.cost[flat_index( f )] > settings.max_length ) {
+        return ret;
+    }
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z );
+    // Walk downhill, every step has to lower the remaining cost
+    tripoint cur = f;
+    while( cur != t ) {
+        const int cur_remaining = field.cost[flat_index( cur )];
+        int cur_part = -1;
+        const vehicle *cur_veh = veh_at_internal( cur, cur_part );
+        int best_cost = INT_MAX;
+        tripoint best = cur;
+        for( const tripoint &p : points_in_radius( cur, 1 ) ) {
+            if( !inbounds( p ) ) {
+                continue;
+            }
+            const int remaining = field.cost[flat_index( p )];
+            if( remaining >= cur_remaining || remaining >= best_cost ) {
+                continue;
+            }
+            const int step = pathfinding_step_cost( cur, p, settings, pf_cache, cur_veh );
+            if( step >= 0 && step + remaining < best_cost ) {
+                best_cost = step + remaining;
+                best = p;
+            }
+        }
+        if( best == cur ) {
+            // Something changed that the pathfinding cache doesn't track, like a vehicle
+            // getting damaged, and the field doesn't match the map anymore
+            return route( f, t, settings );
+        }
+        ret.push_back( best );
+        cur = best;
+    }
+    return ret;
+}
+
+// How far the destination may move before a path to it is searched for again
+static constexpr int route_retarget_range = 3;
+// Creatures further along a path than this will likely have moved on by the time it gets there
+static constexpr size_t route_avoid_steps = 5;
+// Extra cost a repaired path may have before a new search is likely to find a better one
+static constexpr int route_repair_slack = 40;
+// Blocked stretches patched over in one go before a new search is likely to be cheaper
+static constexpr int max_route_repairs = 3;
+
+route_cache_stats &get_route_cache_stats()
+{
+    static route_cache_stats stats;
+    return stats;
+}
+
+int map::route_cost( const std::vector<tripoint> &path, const tripoint &f,
+                     const pathfinding_settings &settings ) const
+{
+    int cost = 0;
+    tripoint prev = f;
+    for( const tripoint &p : path ) {
+        if( p.z != prev.z ) {
+            // Stairs and ramps, as in route
+            cost += 2;
+        } else {
+            int part = -1;
+            const int step = pathfinding_step_cost( prev, p, settings, get_pathfinding_cache_ref( p.z ),
+                                                    veh_at_internal( prev, part ) );
+            if( step < 0 ) {
+                return step;
+            }
+            cost += step;
+        }
+        prev = p;
+    }
+    return cost;
+}
+
+void map::remember_route( const std::vector<tripoint> &path, route_cache &cache,
+                          const tripoint &f, const pathfinding_settings &settings ) const
+{
+    if( path.empty() || !inbounds( f ) ) {
+        cache = route_cache();
+        return;
+    }
+    cache.target = path.back();
+    cache.cost = std::max( route_cost( path, f, settings ), 0 );
+    cache.generation = get_pathfinding_cache_ref( f.z ).generation;
+}
+
+bool map::repair_route( std::vector<tripoint> &path, route_cache &cache, const tripoint &f,
+                        const tripoint &t, const pathfinding_settings &settings,
+                        const std::set<tripoint> &pre_closed ) const
+{
+    route_cache_stats &stats = get_route_cache_stats();
+    while( !path.empty() && path.front() == f ) {
+        path.erase( path.begin() );
+    }
+    if( path.empty() || path.back() != cache.target || !inbounds( f ) || !inbounds( t ) ) {
+        stats.misses++;
+        return false;
+    }
+    const bool same_level = t.z == f.z && std::all_of( path.begin(), path.end(),
+    [&f]( const tripoint & p ) {
+        return p.z == f.z;
+    } );
+    if( !same_level ) {
+        // Stairs can't be checked step by step, trust the path for as long as it leads to t
+        if( path.back() == t && ( path.front().z != f.z || rl_dist( f, path.front() ) <= 1 ) ) {
+            stats.hits++;
+            return true;
+        }
+        stats.misses++;
+        return false;
+    }
+    if( rl_dist( f, path.front() ) > 1 ) {
+        // Pushed or pulled off the path
+        stats.misses++;
+        return false;
+    }
+
+    std::vector<tripoint> fixed = path;
+    bool repaired = false;
+    if( fixed.back() != t ) {
+        if( square_dist( fixed.back(), t ) > route_retarget_range ) {
+            stats.misses++;
+            return false;
+        }
+        // Cut the path where it comes closest to the new destination and walk over from there
+        size_t kept = 0;
+        int closest = rl_dist( f, t );
+        for( size_t i = 0; i < fixed.size(); i++ ) {
+            const int dist = rl_dist( fixed[i], t );
+            if( dist < closest ) {
+                closest = dist;
+                kept = i + 1;
+            }
+        }
+        const tripoint from = kept == 0 ? f : fixed[kept - 1];
+        fixed.resize( kept );
+        if( from != t ) {
+            const std::vector<tripoint> leg = route_locally( from, t, settings, pre_closed );
+            if( leg.empty() ) {
+                stats.misses++;
+                return false;
+            }
+            fixed.insert( fixed.end(), leg.begin(), leg.end() );
+        }
+        repaired = true;
+    }
+
+    const pathfinding_cache &pf_cache = get_pathfinding_cache_ref( f.z );
+    const auto occupied = [&]( const size_t i ) {
+        return i < route_avoid_steps && fixed[i] != t && pre_closed.count( fixed[i] ) != 0;
+    };
+    bool check_steps = repaired || cache.generation != pf_cache.generation;
+    for( size_t i = 0; i < fixed.size() && !check_steps; i++ ) {
+        check_steps = occupied( i );
+    }
+    if( check_steps ) {
+        const auto step_cost = [&]( const size_t i ) {
+            if( occupied( i ) ) {
+                return static_cast<int>( PF_STEP_CLOSED );
+            }
+            const tripoint &prev = i == 0 ? f : fixed[i - 1];
+            int part = -1;
+            return pathfinding_step_cost( prev, fixed[i], settings, pf_cache, veh_at_internal( prev, part ) );
+        };
+        int cost = 0;
+        int repairs = 0;
+        size_t i = 0;
+        while( i < fixed.size() ) {
+            const int step = step_cost( i );
+            if( step >= 0 ) {
+                cost += step;
+                i++;
+                continue;
+            }
+            // Walk around the blocked stretch, back onto the first tile after it
+            size_t rejoin = i + 1;
+            while( rejoin < fixed.size() && step_cost( rejoin ) < 0 ) {
+                rejoin++;
+            }
+            if( ++repairs > max_route_repairs || rejoin >= fixed.size() ) {
+                stats.misses++;
+                return false;
+            }
+            const tripoint &prev = i == 0 ? f : fixed[i - 1];
+            const std::vector<tripoint> detour = route_locally( prev, fixed[rejoin], settings, pre_closed );
+            if( detour.empty() ) {
+                stats.misses++;
+                return false;
+            }
+            // The detour ends on the tile it rejoins at, it gets checked with the rest
+            fixed.erase( fixed.begin() + i, fixed.begin() + rejoin + 1 );
+            fixed.insert( fixed.begin() + i, detour.begin(), detour.end() );
+            repaired = true;
+        }
+        if( repaired && cost > cache.cost + route_repair_slack ) {
+            stats.misses++;
+            return false;
+        }
+        cache.cost = cost;
+        cache.generation = pf_cache.generation;
+    }
+
+    path = std::move( fixed );
+    cache.target = t;
+    if( repaired ) {
+        stats.repairs++;
+    } else {
+        stats.hits++;
+    }
+    return true;
+}
+
+// Estimated cost of stepping onto p for the portal graph, -1 if it can't be walked onto
+static int portal_step_cost( const map &m, const pathfinding_cache &pf_cache, const tripoint &p )
+{
+    const pf_special special = pf_cache.special[p.x][p.y];
+    if( !( special & PF_WALL ) ) {
+        return special & PF_SLOW ? 4 : 2;
+    }
+    if( m.ter( p ).obj().open || m.furn( p ).obj().open ) {
+        // Opening a door, as in map::pathfinding_step_cost
+        return 6;
+    }
+    return -1;
+}
+
+static tripoint submap_of( const tripoint &p )
+{
+    return tripoint( p.x / SEEX, p.y / SEEY, p.z );
+}
+
+// Index of p into portal_graph::cluster::tile_costs
+static int submap_index( const tripoint &p )
+{
+    return p.x % SEEX * SEEY + p.y % SEEY;
+}
+
+void portal_graph::invalidate( const int zlev )
+{
+    for( cluster &c : levels[zlev + OVERMAP_DEPTH] ) {
+        c.dirty = true;
+    }
+}
+
+void portal_graph::invalidate( const tripoint &p )
+{
+    // Neighbours share the crossings on their edges, stairs lead anywhere within the
+    // overmap tile on the levels above and below
+    const tripoint sm = submap_of( p );
+    for( int z = std::max( p.z - 1, -OVERMAP_DEPTH ); z <= std::min( p.z + 1, OVERMAP_HEIGHT ); z++ ) {
+        std::vector<cluster> &level = levels[z + OVERMAP_DEPTH];
+        if( level.empty() ) {
+            continue;
+        }
+        for( int x = std::max( sm.x - 1, 0 ); x <= std::min( sm.x + 1, mapsize - 1 ); x++ ) {
+            for( int y = std::max( sm.y - 1, 0 ); y <= std::min( sm.y + 1, mapsize - 1 ); y++ ) {
+                level[x + y * mapsize].dirty = true;
+            }
+        }
+    }
+}
+
+portal_graph::cluster &portal_graph::get_cluster( const map &m, const tripoint &sm )
+{
+    mapsize = m.getmapsize();
+    std::vector<cluster> &level = levels[sm.z + OVERMAP_DEPTH];
+    if( level.size() != static_cast<size_t>( mapsize * mapsize ) ) {
+        level.assign( mapsize * mapsize, cluster() );
+    }
+    cluster &c = level[sm.x + sm.y * mapsize];
+    if( c.dirty ) {
+        rebuild( m, sm, c );
+    }
+    return c;
+}
+
+std::array < int, SEEX * SEEY > portal_graph::submap_costs( const cluster &c, const point &start )
+{
+    std::array < int, SEEX * SEEY > ret;
+    ret.fill( INT_MAX );
+    bucket_queue open;
+    ret[start.x * SEEY + start.y] = 0;
+    open.push( 0, tripoint( start, 0 ) );
+    while( !open.empty() ) {
+        const tripoint cur = open.pop();
+        const int cur_cost = ret[cur.x * SEEY + cur.y];
+        for( const point &offset : eight_adjacent_offsets ) {
+            const point p = cur.xy() + offset;
+            if( p.x < 0 || p.x >= SEEX || p.y < 0 || p.y >= SEEY ) {
+                continue;
+            }
+            const int index = p.x * SEEY + p.y;
+            if( c.tile_costs[index] < 0 ) {
+                continue;
+            }
+            const int cost = cur_cost + c.tile_costs[index] + ( offset.x != 0 && offset.y != 0 ? 1 : 0 );
+            if( cost < ret[index] ) {
+                ret[index] = cost;
+                open.push( cost, tripoint( p, 0 ) );
+            }
+        }
+    }
+    return ret;
+}
+
+void portal_graph::rebuild( const map &m, const tripoint &sm, cluster &c )
+{
+    c.dirty = false;
+    c.portals.clear();
+    const pathfinding_cache &pf_cache = m.get_pathfinding_cache_ref( sm.z );
+    const tripoint origin( sm.x * SEEX, sm.y * SEEY, sm.z );
+    for( int x = 0; x < SEEX; x++ ) {
+        for( int y = 0; y < SEEY; y++ ) {
+            c.tile_costs[x * SEEY + y] = portal_step_cost( m, pf_cache, origin + point( x, y ) );
+        }
+    }
+
+    const auto get_portal = [&c]( const tripoint & p ) -> portal & {
+        const auto iter = std::find_if( c.portals.begin(), c.portals.end(), [&p]( const portal & pt )
+        {
+            return pt.pos == p;
+        } );
+        if( iter != c.portals.end() )
+        {
+            return *iter;
+        }
+        c.portals.push_back( portal{ p, {} } );
+        return c.portals.back();
+    };
+
+    // Crossings into the neighbours: one in the middle of each short run of tiles passable
+    // on both sides of the edge, one at either end of longer runs.
+    // The neighbour finds the same runs from its side, so every crossing is a portal on both.
+    for( const point &dir : four_adjacent_offsets ) {
+        const point neighbour = sm.xy() + dir;
+        if( neighbour.x < 0 || neighbour.x >= mapsize || neighbour.y < 0 || neighbour.y >= mapsize ) {
+            continue;
+        }
+        const tripoint edge = origin + point( dir.x > 0 ? SEEX - 1 : 0, dir.y > 0 ? SEEY - 1 : 0 );
+        const point along = dir.x != 0 ? point_south : point_east;
+        const auto passable = [&]( const int i ) {
+            const tripoint inside = edge + along * i;
+            return c.tile_costs[submap_index( inside )] >= 0 &&
+                   portal_step_cost( m, pf_cache, inside + dir ) >= 0;
+        };
+        const auto add_crossing = [&]( const int i ) {
+            const tripoint inside = edge + along * i;
+            get_portal( inside ).exits.emplace_back( inside + dir, 2 );
+        };
+        for( int i = 0; i < SEEX; i++ ) {
+            if( !passable( i ) ) {
+                continue;
+            }
+            const int run_start = i;
+            while( i + 1 < SEEX && passable( i + 1 ) ) {
+                i++;
+            }
+            if( i - run_start < 5 ) {
+                add_crossing( ( run_start + i ) / 2 );
+            } else {
+                add_crossing( run_start );
+                add_crossing( i );
+            }
+        }
+    }
+
+    // Every staircase and ramp is a portal, even if it doesn't lead anywhere from this side,
+    // so that the ones on other levels can lead to it
+    if( m.has_zlevels() ) {
+        for( int x = 0; x < SEEX; x++ ) {
+            for( int y = 0; y < SEEY; y++ ) {
+                const tripoint p = origin + point( x, y );
+                if( !( pf_cache.special[p.x][p.y] & PF_UPDOWN ) ) {
+                    continue;
+                }
+                portal &pt = get_portal( p );
+                const ter_t &terrain = m.ter( p ).obj();
+                if( p.z > -OVERMAP_DEPTH && terrain.has_flag( TFLAG_GOES_DOWN ) ) {
+                    tripoint dest( p.xy(), p.z - 1 );
+                    if( vertical_move_destination<TFLAG_GOES_UP>( m, dest ) ) {
+                        pt.exits.emplace_back( dest, 2 );
+                    }
+                }
+                if( p.z < OVERMAP_HEIGHT && terrain.has_flag( TFLAG_GOES_UP ) ) {
+                    tripoint dest( p.xy(), p.z + 1 );
+                    if( vertical_move_destination<TFLAG_GOES_DOWN>( m, dest ) ) {
+                        pt.exits.emplace_back( dest, 2 );
+                    }
+                }
+                // Ramps lead next to the tile above or below, so through it and off again
+                if( p.z < OVERMAP_HEIGHT &&
+                    ( terrain.has_flag( TFLAG_RAMP ) || terrain.has_flag( TFLAG_RAMP_UP ) ) ) {
+                    const tripoint above( p.xy(), p.z + 1 );
+                    if( m.get_pathfinding_cache_ref( above.z ).special[p.x][p.y] & PF_UPDOWN ) {
+                        pt.exits.emplace_back( above, 6 );
+                    }
+                }
+                if( p.z > -OVERMAP_DEPTH && terrain.has_flag( TFLAG_RAMP_DOWN ) ) {
+                    const tripoint below( p.xy(), p.z - 1 );
+                    if( m.get_pathfinding_cache_ref( below.z ).special[p.x][p.y] & PF_UPDOWN ) {
+                        pt.exits.emplace_back( below, 6 );
+                    }
+                }
+            }
+        }
+    }
+
+    const size_t count = c.portals.size();
+    c.costs.assign( count * count, INT_MAX );
+    for( size_t i = 0; i < count; i++ ) {
+        const tripoint start = c.portals[i].pos - origin;
+        const std::array < int, SEEX * SEEY > costs = submap_costs( c, start.xy() );
+        for( size_t j = 0; j < count; j++ ) {
+            c.costs[i * count + j] = costs[submap_index( c.portals[j].pos )];
+        }
+    }
+}
+
+std::vector<tripoint> portal_graph::find_route( const map &m, const tripoint &f,
+        const tripoint &t, const int max_cost, const std::set<tripoint> &closed )
+{
+    const cluster &start = get_cluster( m, submap_of( f ) );
+    const std::array < int, SEEX * SEEY > start_costs =
+        submap_costs( start, point( f.x % SEEX, f.y % SEEY ) );
+    const tripoint goal = submap_of( t );
+    // Walking is about as expensive both ways, so this is also the cost of getting to t
+    const std::array < int, SEEX * SEEY > goal_costs =
+        submap_costs( get_cluster( m, goal ), point( t.x % SEEX, t.y % SEEY ) );
+
+    struct visit {
+        int cost;
+        tripoint parent;
+        bool closed;
+    };
+    std::unordered_map<tripoint, visit> visited;
+    bucket_queue open;
+    const auto reach = [&]( const tripoint & p, const int cost, const tripoint & parent ) {
+        if( cost > max_cost || closed.count( p ) != 0 ) {
+            return;
+        }
+        const auto iter = visited.find( p );
+        if( iter != visited.end() && ( iter->second.closed || cost >= iter->second.cost ) ) {
+            return;
+        }
+        visited[p] = visit{ cost, parent, false };
+        open.push( cost + 2 * rl_dist( p, t ), p );
+    };
+
+    for( const portal &pt : start.portals ) {
+        const int cost = start_costs[submap_index( pt.pos )];
+        if( cost != INT_MAX ) {
+            reach( pt.pos, cost, f );
+        }
+    }
+
+    int best_cost = INT_MAX;
+    tripoint last = f;
+    while( !open.empty() ) {
+        const tripoint cur = open.pop();
+        visit &cur_visit = visited[cur];
+        if( cur_visit.closed ) {
+            continue;
+        }
+        cur_visit.closed = true;
+        const int cur_cost = cur_visit.cost;
+        if( cur_cost + 2 * rl_dist( cur, t ) >= best_cost ) {
+            break;
+        }
+
+        const tripoint sm = submap_of( cur );
+        const cluster &c = get_cluster( m, sm );
+        const auto iter = std::find_if( c.portals.begin(), c.portals.end(),
+        [&cur]( const portal & pt ) {
+            return pt.pos == cur;
+        } );
+        if( iter == c.portals.end() ) {
+            // The portal leading here is outdated
+            continue;
+        }
+        if( sm == goal && goal_costs[submap_index( cur )] != INT_MAX &&
+            cur_cost + goal_costs[submap_index( cur )] < best_cost ) {
+            best_cost = cur_cost + goal_costs[submap_index( cur )];
+            last = cur;
+        }
+        const size_t count = c.portals.size();
+        const size_t index = std::distance( c.portals.begin(), iter );
+        for( size_t j = 0; j < count; j++ ) {
+            const int cost = c.costs[index * count + j];
+            if( j != index && cost != INT_MAX ) {
+                reach( c.portals[j].pos, cur_cost + cost, cur );
+            }
+        }
+        for( const std::pair<tripoint, int> &exit : iter->exits ) {
+            reach( exit.first, cur_cost + exit.second, cur );
+        }
+    }
+
+    std::vector<tripoint> ret;
+    if( best_cost > max_cost ) {
+        return ret;
+    }
+    ret.push_back( t );
+    for( tripoint cur = last; cur != f; cur = visited[cur].parent ) {
+        ret.push_back( cur );
+    }
+    std::reverse( ret.begin(), ret.end() );
+    return ret;
+}
@@ -2,7 +2,14 @@
 #ifndef CATA_SRC_PATHFINDING_H
 #define CATA_SRC_PATHFINDING_H
 
+#include <array>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "calendar.h"
 #include "game_constants.h"
+#include "point.h"
 
 enum pf_special : int {
     PF_NORMAL = 0x00,    // Plain boring tile (grass, dirt, floor etc.)
@@ -38,11 +45,20 @@ inline pf_special &operator &= ( pf_special &lhs, pf_special rhs )
     return lhs;
 }
 
+// Results of map::pathfinding_step_cost that aren't a cost
+enum pf_step : int {
+    PF_STEP_SKIP = -1,   // Can't step there from here, but maybe from elsewhere
+    PF_STEP_CLOSED = -2, // Can't step there from anywhere
+    PF_STEP_LEDGE = -3,  // Trapped ledge, to drop down from rather than walk onto
+};
+
 struct pathfinding_cache {
     pathfinding_cache();
     ~pathfinding_cache();
 
     bool dirty;
+    // Incremented every time the cache is rebuilt
+    int generation = 0;
 
     pf_special special[MAPSIZE_X][MAPSIZE_Y];
 };
@@ -71,6 +87,111 @@ struct pathfinding_settings {
           allow_open_doors( aod ), avoid_traps( at ), allow_climb_stairs( acs ), avoid_rough_terrain( art ),
           avoid_sharp( as ) {}
     pathfinding_settings &operator = ( const pathfinding_settings & ) = default;
+
+    bool operator==( const pathfinding_settings &rhs ) const {
+        return bash_strength == rhs.bash_strength && max_dist == rhs.max_dist &&
+               max_length == rhs.max_length && climb_cost == rhs.climb_cost &&
+               allow_open_doors == rhs.allow_open_doors && avoid_traps == rhs.avoid_traps &&
+               allow_climb_stairs == rhs.allow_climb_stairs &&
+               avoid_rough_terrain == rhs.avoid_rough_terrain && avoid_sharp == rhs.avoid_sharp;
+    }
+};
+
+/**
+ * Cost of the cheapest route to @ref target from every tile of its z-level, for creatures
+ * moving with @ref settings. See map::route_to_shared_target.
+ */
+struct flow_field {
+    tripoint target;
+    pathfinding_settings settings;
+    // Only valid during the turn it was made in, and while the pathfinding cache of its
+    // z-level is still the one it was made from
+    time_point turn;
+    int cache_generation = 0;
+    // Indexed like pathfinding_cache::special, flattened
+    std::array < int, MAPSIZE_X * MAPSIZE_Y > cost;
+};
+
+/**
+ * Bookkeeping kept next to a creature's path, so that map::repair_route can tell
+ * whether the path still holds.
+ */
+struct route_cache {
+    // Destination the path leads to
+    tripoint target;
+    // Cost of what was left of the path when it was last checked
+    int cost = 0;
+    // pathfinding_cache::generation of the path's z-level when it was last checked
+    int generation = -1;
+};
+
+// What became of the paths passed to map::repair_route, for debugging
+struct route_cache_stats {
+    // Still good as they were
+    int hits = 0;
+    // Patched up locally
+    int repairs = 0;
+    // Had to be searched for again
+    int misses = 0;
+};
+
+route_cache_stats &get_route_cache_stats();
+
+class map;
+
+/**
+ * Abstract graph over the submaps of a map, used by map::route to plan long routes
+ * before filling in the tiles between the stops.
+ *
+ * Nodes are portals: tiles on the edge of a submap that lead into the next one, and stairs
+ * and ramps that lead to another z-level. Portals on the same submap are connected by
+ * the cost of walking between them without leaving it. Costs are estimates made from
+ * the pathfinding cache for a creature that can open doors, the refined route decides.
+ *
+ * Submaps are rebuilt when next needed after a change in or next to them was reported.
+ */
+class portal_graph
+{
+    public:
+        /** Everything on z-level @p zlev has to be rebuilt. */
+        void invalidate( int zlev );
+        /** The tile at @p p changed. */
+        void invalidate( const tripoint &p );
+
+        /**
+         * Portals to pass on the way from @p f to @p t, followed by @p t itself.
+         * Portals in @p closed are left out.
+         * Empty if there is no way within @p max_cost.
+         */
+        std::vector<tripoint> find_route( const map &m, const tripoint &f, const tripoint &t,
+                                          int max_cost, const std::set<tripoint> &closed );
+
+    private:
+        struct portal {
+            tripoint pos;
+            // Portals on other submaps reachable from this one, and the cost of getting there
+            std::vector<std::pair<tripoint, int>> exits;
+        };
+
+        struct cluster {
+            bool dirty = true;
+            // Cost of stepping onto each tile, -1 where it's impassable
+            std::array < int, SEEX * SEEY > tile_costs;
+            std::vector<portal> portals;
+            // Cost between each two portals without leaving the submap, INT_MAX if there's no way
+            // Indexed by the index of the first portal times the number of portals plus the second
+            std::vector<int> costs;
+        };
+
+        // Submaps of each z-level, row after row, empty until first needed
+        std::array<std::vector<cluster>, OVERMAP_LAYERS> levels;
+        // Submaps per row and column of the map
+        int mapsize = 0;
+
+        cluster &get_cluster( const map &m, const tripoint &sm );
+        void rebuild( const map &m, const tripoint &sm, cluster &c );
+        // Cost of walking from local tile @p start to every tile of the submap
+        static std::array < int, SEEX * SEEY > submap_costs( const cluster &c, const point &start );
 };
 
 #endif // CATA_SRC_PATHFINDING_H
@@ -1,8 +1,10 @@
 #include "game.h" // IWYU pragma: associated
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
@@ -397,6 +399,60 @@ void overmap::convert_terrain(
     }
 }
 
+void overmap::load_packed_terrain( const std::vector<std::string> &ids,
+                                   const std::array<std::vector<int>, OVERMAP_LAYERS> &runs )
+{
+    std::vector<oter_id> resolved;
+    std::vector<bool> obsolete;
+    resolved.reserve( ids.size() );
+    obsolete.reserve( ids.size() );
+    for( const std::string &id : ids ) {
+        obsolete.push_back( is_obsolete_terrain( id ) );
+        if( obsolete.back() ) {
+            resolved.emplace_back( 0 );
+        } else if( oter_str_id( id ).is_valid() ) {
+            resolved.emplace_back( id );
+        } else {
+            debugmsg( "Loaded bad ter!  ter %s", id.c_str() );
+            resolved.emplace_back( 0 );
+        }
+    }
+
+    std::unordered_map<tripoint_om_omt, std::string> needs_conversion;
+    for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
+        const std::vector<int> &layer_runs = runs[z];
+        if( layer_runs.size() % 2 != 0 ) {
+            throw std::runtime_error( string_format( "terrain layer %d is malformed", z ) );
+        }
+        std::vector<std::pair<oter_id, int>> packed;
+        packed.reserve( layer_runs.size() / 2 );
+        int pos = 0;
+        for( size_t r = 0; r < layer_runs.size(); r += 2 ) {
+            const int index = layer_runs[r];
+            const int count = layer_runs[r + 1];
+            if( index < 0 || static_cast<size_t>( index ) >= resolved.size() || count <= 0 ||
+                pos + count > OMAPX * OMAPY ) {
+                throw std::runtime_error( string_format( "terrain layer %d is malformed", z ) );
+            }
+            if( obsolete[index] ) {
+                for( int p = pos; p < pos + count; p++ ) {
+                    needs_conversion.emplace(
+                        tripoint_om_omt( p % OMAPX, p / OMAPX, z - OVERMAP_DEPTH ), ids[index] );
+                }
+            }
+            packed.emplace_back( resolved[index], count );
+            pos += count;
+        }
+        if( pos != OMAPX * OMAPY ) {
+            throw std::runtime_error( string_format( "terrain layer %d has %d tiles instead of %d",
+                                      z, pos, OMAPX * OMAPY ) );
+        }
+        packed_terrain[z] = std::move( packed );
+    }
+    // Conversion sets the terrain via ter_set, which unpacks the affected layers.
+    convert_terrain( needs_conversion );
+}
+
 void overmap::load_monster_groups( JsonIn &jsin )
 {
     jsin.start_array();
@@ -433,10 +489,21 @@ void overmap::unserialize( std::istream &fin, const std::string &file_path )
 {
     chkversion( fin );
     JsonIn jsin( fin, file_path );
+    std::vector<std::string> terrain_ids;
+    std::array<std::vector<int>, OVERMAP_LAYERS> terrain_runs;
     jsin.start_object();
     while( !jsin.end_object() ) {
         const std::string name = jsin.get_member_name();
-        if( name == "layers" ) {
+        if( name == "terrain_ids" ) {
+            jsin.read( terrain_ids, true );
+        } else if( name == "terrain_layers" ) {
+            jsin.start_array();
+            for( std::vector<int> &layer_runs : terrain_runs ) {
+                jsin.read( layer_runs, true );
+            }
+            jsin.end_array();
+        } else if( name == "layers" ) {
+            // Legacy format: runs of terrain id strings.
             std::unordered_map<tripoint_om_omt, std::string> needs_conversion;
             jsin.start_array();
             for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
@@ -677,6 +744,9 @@ void overmap::unserialize( std::istream &fin, const std::string &file_path )
             }
         }
     }
+    if( !terrain_ids.empty() ) {
+        load_packed_terrain( terrain_ids, terrain_runs );
+    }
 }
 
 static void unserialize_array_from_compacted_sequence( JsonIn &jsin, bool ( &array )[OMAPX][OMAPY] )
@@ -798,7 +868,7 @@ void overmap::serialize_view( std::ostream &fout ) const
         json.start_array();
         serialize_array_to_compacted_sequence( json, layer[z].visible );
         json.end_array();
-        fout << std::endl;
+        json.write_newline();
     }
     json.end_array();
 
@@ -808,7 +878,7 @@ void overmap::serialize_view( std::ostream &fout ) const
         json.start_array();
         serialize_array_to_compacted_sequence( json, layer[z].explored );
         json.end_array();
-        fout << std::endl;
+        json.write_newline();
     }
     json.end_array();
 
@@ -824,7 +894,7 @@ void overmap::serialize_view( std::ostream &fout ) const
             json.write( i.dangerous );
             json.write( i.danger_radius );
             json.end_array();
-            fout << std::endl;
+            json.write_newline();
         }
         json.end_array();
     }
@@ -840,7 +910,7 @@ void overmap::serialize_view( std::ostream &fout ) const
             json.write( i.p.y() );
             json.write( i.id );
             json.end_array();
-            fout << std::endl;
+            json.write_newline();
         }
         json.end_array();
     }
@@ -919,47 +989,72 @@ void overmap::serialize( std::ostream &fout ) const
     JsonOut json( fout, false );
     json.start_object();
 
-    json.member( "layers" );
-    json.start_array();
+    // Terrain is stored as runs of (index into "terrain_ids", length) per z-level,
+    // so loading does not have to look up an id string for every run.
+    std::vector<oter_id> terrain_ids;
+    std::unordered_map<oter_id, int> terrain_index;
+    std::array<std::vector<int>, OVERMAP_LAYERS> terrain_runs;
+    const auto add_run = [&]( std::vector<int> &layer_runs, const oter_id & t, int count ) {
+        const auto inserted = terrain_index.emplace( t, static_cast<int>( terrain_ids.size() ) );
+        if( inserted.second ) {
+            terrain_ids.push_back( t );
+        }
+        layer_runs.push_back( inserted.first->second );
+        layer_runs.push_back( count );
+    };
     for( int z = 0; z < OVERMAP_LAYERS; ++z ) {
+        std::vector<int> &layer_runs = terrain_runs[z];
+        if( !packed_terrain[z].empty() ) {
+            // Never accessed since loading, no need to unpack it.
+            for( const std::pair<oter_id, int> &run : packed_terrain[z] ) {
+                add_run( layer_runs, run.first, run.second );
+            }
+            continue;
+        }
         auto &layer_terrain = layer[z].terrain;
         int count = 0;
         oter_id last_tertype( -1 );
-        json.start_array();
         for( int j = 0; j < OMAPY; j++ ) {
             // NOLINTNEXTLINE(modernize-loop-convert)
             for( int i = 0; i < OMAPX; i++ ) {
                 oter_id t = layer_terrain[i][j];
                 if( t != last_tertype ) {
                     if( count ) {
-                        json.write( count );
-                        json.end_array();
+                        add_run( layer_runs, last_tertype, count );
                     }
                     last_tertype = t;
-                    json.start_array();
-                    json.write( t.id() );
                     count = 1;
                 } else {
                     count++;
                 }
             }
         }
-        json.write( count );
-        // End the last entry for a z-level.
-        json.end_array();
-        // End the z-level
-        json.end_array();
+        add_run( layer_runs, last_tertype, count );
+    }
+
+    json.member( "terrain_ids" );
+    json.start_array();
+    for( const oter_id &t : terrain_ids ) {
+        json.write( t.id() );
+    }
+    json.end_array();
+    json.write_newline();
+
+    json.member( "terrain_layers" );
+    json.start_array();
+    for( const std::vector<int> &layer_runs : terrain_runs ) {
+        json.write( layer_runs );
         // Insert a newline occasionally so the file isn't totally unreadable.
-        fout << std::endl;
+        json.write_newline();
     }
     json.end_array();
 
     // temporary, to allow user to manually switch regions during play until regionmap is done.
     json.member( "region_id", settings->id );
-    fout << std::endl;
+    json.write_newline();
 
     save_monster_groups( json );
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "cities" );
     json.start_array();
@@ -972,7 +1067,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "labs" );
     json.start_array();
@@ -984,10 +1079,10 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "connections_out", connections_out );
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "radios" );
     json.start_array();
@@ -1002,7 +1097,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "monster_map" );
     json.start_array();
@@ -1011,7 +1106,7 @@ void overmap::serialize( std::ostream &fout ) const
         i.second.serialize( json );
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "tracked_vehicles" );
     json.start_array();
@@ -1024,7 +1119,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "scent_traces" );
     json.start_array();
@@ -1036,7 +1131,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "npcs" );
     json.start_array();
@@ -1044,7 +1139,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.write( *i );
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "camps" );
     json.start_array();
@@ -1052,7 +1147,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.write( i );
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     // Condense the overmap special placements so that all placements of a given special
     // are grouped under a single key for that special.
@@ -1085,7 +1180,7 @@ void overmap::serialize( std::ostream &fout ) const
         json.end_object();
     }
     json.end_array();
-    fout << std::endl;
+    json.write_newline();
 
     json.member( "electric_grid_connections" );
     json.start_array();
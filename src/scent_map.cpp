@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include "assign.h"
 #include "calendar.h"
@@ -18,6 +20,12 @@
 
 static constexpr int SCENT_RADIUS = 40;
 
+// Same as n / 250, as a multiply and shift the compiler can vectorize
+static int divide_by_250( const int n )
+{
+    return static_cast<int>( ( static_cast<int64_t>( n ) * 0x10624DD3 ) >> 36 ) + ( n < 0 );
+}
+
 static nc_color sev( const size_t level )
 {
     static const std::array<nc_color, 22> colors = { {
@@ -162,10 +170,6 @@ void scent_map::update( const tripoint &center, map &m )
     //block=0 reduce=1 normal=5
     scent_array<char> scent_transfer;
 
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
-    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
-    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
-
     diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
                 center.z ).vehicle_obstructed_cache;
 
@@ -179,66 +183,85 @@ void scent_map::update( const tripoint &center, map &m )
     m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
                       point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        sum_3_scent_y[0][x] = 0;
-        squares_used_y[0][x] = 0;
-        sum_3_scent_y[SCENT_RADIUS * 2][x] = 0;
-        squares_used_y[SCENT_RADIUS * 2][x] = 0;
+    // The blur is split into a vertical and a horizontal pass. All the buffers below are
+    // indexed [x][y] like grscent, so the inner loops run over contiguous memory.
+    constexpr int size = SCENT_RADIUS * 2 + 1;
+
+    // Scent and transfer of the 3 squares around every square of the window, summed along y.
+    // There is one extra column on each side for the horizontal pass.
+    std::array < std::array<int, size>, size + 2 > sum_3_scent_y;
+    std::array < std::array<int, size>, size + 2 > squares_used_y;
+    for( int x = 0; x < size + 2; ++x ) {
+        const std::array<int, MAPSIZE_Y> &scent = grscent[x + scentmap_minx - 1];
+        const std::array<char, MAPSIZE_Y> &transfer = scent_transfer[x + scentmap_minx - 1];
+        // Scent weighted by transfer, from one square above the window to one below it
+        std::array < int, size + 2 > weighted;
+        std::array < int, size + 2 > transfer_column;
+        for( int y = 0; y < size + 2; ++y ) {
+            const int abs_y = y + scentmap_miny - 1;
+            transfer_column[y] = transfer[abs_y];
+            weighted[y] = transfer[abs_y] * scent[abs_y];
+        }
+        for( int y = 0; y < size; ++y ) {
+            sum_3_scent_y[x][y] = weighted[y] + weighted[y + 1] + weighted[y + 2];
+            squares_used_y[x][y] = transfer_column[y] + transfer_column[y + 1] + transfer_column[y + 2];
+        }
     }
 
-    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-
-            point abs( x + scentmap_minx - 1, y + scentmap_miny );
-
-            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
-            sum_3_scent_y[y][x] = 0;
-            squares_used_y[y][x] = 0;
-            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
-                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
-                squares_used_y[y][x] += scent_transfer[abs.x][i];
-            }
+    // The same summed along x, for the 3x3 squares around every square of the window
+    std::array<std::array<int, size>, size> total;
+    std::array<std::array<int, size>, size> squares_used;
+    for( int x = 0; x < size; ++x ) {
+        for( int y = 0; y < size; ++y ) {
+            total[x][y] = sum_3_scent_y[x][y] + sum_3_scent_y[x + 1][y] + sum_3_scent_y[x + 2][y];
+            squares_used[x][y] = squares_used_y[x][y] + squares_used_y[x + 1][y] + squares_used_y[x + 2][y];
         }
     }
 
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
-
-            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
-            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
-
-            //handle vehicle holes
-            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y + 1];
-            }
-            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x - 1][abs.y - 1];
+    // Handle vehicle holes: scent doesn't pass diagonally between two squares separated by
+    // a diagonal vehicle wall, in either direction. Those are rare, so this scans for them
+    // and corrects both squares instead of checking all four diagonals of every square.
+    const auto block_diagonal = [&]( const point & from, const point & to ) {
+        const point window( from.x - scentmap_minx, from.y - scentmap_miny );
+        if( window.x >= 0 && window.x < size && window.y >= 0 && window.y < size &&
+            scent_transfer[to.x][to.y] == 5 ) {
+            squares_used[window.x][window.y] -= 4;
+            total[window.x][window.y] -= 4 * grscent[to.x][to.y];
+        }
+    };
+    static const diagonal_blocks no_blocks[size + 1] = {};
+    for( int x = scentmap_minx - 1; x <= scentmap_maxx + 1; ++x ) {
+        if( std::memcmp( &blocked_cache[x][scentmap_miny - 1], no_blocks, sizeof( no_blocks ) ) == 0 ) {
+            continue;
+        }
+        for( int y = scentmap_miny - 1; y <= scentmap_maxy; ++y ) {
+            const diagonal_blocks &blocks = blocked_cache[x][y];
+            if( blocks.nw ) {
+                block_diagonal( point( x, y ), point( x + 1, y + 1 ) );
+                block_diagonal( point( x + 1, y + 1 ), point( x, y ) );
             }
-            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
-                squares_used -= 4;
-                total -= 4 * grscent[abs.x + 1][abs.y - 1];
+            if( blocks.ne ) {
+                block_diagonal( point( x, y ), point( x - 1, y + 1 ) );
+                block_diagonal( point( x - 1, y + 1 ), point( x, y ) );
             }
+        }
+    }
 
-            //Lingering scent
-            int temp_scent =  grscent[abs.x][abs.y] * ( 250 - squares_used  *
-                              scent_transfer[abs.x][abs.y] ) ;
-            temp_scent -=  grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] *
-                           ( 45 - squares_used ) / 5;
+    // Every square only reads its own old scent from here on, so it can be updated in place
+    for( int x = 0; x < size; ++x ) {
+        std::array<int, MAPSIZE_Y> &scent = grscent[x + scentmap_minx];
+        const std::array<char, MAPSIZE_Y> &transfer = scent_transfer[x + scentmap_minx];
+        for( int y = 0; y < size; ++y ) {
+            const int abs_y = y + scentmap_miny;
+            const int here = scent[abs_y];
+            const int transfer_here = transfer[abs_y];
+            const int used = squares_used[x][y];
 
-            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+            //Lingering scent
+            int temp_scent = here * ( 250 - used * transfer_here );
+            temp_scent -= here * transfer_here * ( 45 - used ) / 5;
 
-        }
-    }
-    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
-        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
-            grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+            scent[abs_y] = divide_by_250( temp_scent + total[x][y] * transfer_here );
         }
     }
 }
@@ -2,11 +2,19 @@
 #ifndef CATA_SRC_SIMPLE_PATHFINDING_H
 #define CATA_SRC_SIMPLE_PATHFINDING_H
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <cstdlib>
 #include <functional>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "coordinates.h"
 #include "enums.h"
+#include "line.h"
 #include "om_direction.h"
 #include "optional.h"
 #include "point.h"
@@ -116,15 +124,248 @@ struct omt_score {
 
 using omt_scoring_fn = std::function<omt_score( tripoint_abs_omt )>;
 
+namespace overmap_search
+{
+
+/*
+ * A node address annotated with its heuristic score, an approximation of how
+ * much it would cost to reach the goal through this node.
+ */
+struct scored_address {
+    tripoint_abs_omt addr;
+    int32_t score;
+    bool operator> ( const scored_address &other ) const {
+        return score > other.score;
+    }
+};
+
+/*
+ * Data structure representing a navigation node that is known to be reachable. Contains
+ * information about the path to get there and enough information to predict which nodes
+ * may be reached from it.
+ */
+struct navigation_node {
+    // Cost incurred to reach this node.
+    int32_t cumulative_cost;
+    // Cost of the node itself
+    int16_t node_cost;
+    // Direction towards the previous node in the path [3D].
+    // Compressed encoding of "direction" enum.
+    int8_t prev_dir;
+    // Whether z-level transitions are permitted from this node.
+    bool allow_z_change;
+
+    direction get_prev_dir() const {
+        return static_cast<direction>( prev_dir );
+    }
+};
+
+const tripoint &direction_to_tripoint( direction dir );
+direction reverse_direction( direction dir );
+const std::vector<direction> &enumerate_directions( bool allow_z_change );
+int adjust_omt_cost( int base_cost, direction dir_in, direction dir_out );
+
+/*
+ * The nodes reached by one end of a search. They are kept in square blocks of OMTs, so
+ * that the neighbours of a node are usually found without hashing their position.
+ * Clearing keeps the blocks around for the next search.
+ */
+class node_map
+{
+    public:
+        void clear();
+
+        size_t size() const {
+            return node_count;
+        }
+
+        navigation_node *find( const tripoint_abs_omt &p ) {
+            block *b = get_block( p, false );
+            if( b == nullptr ) {
+                return nullptr;
+            }
+            const int i = index_in_block( p );
+            return b->known[i] ? &b->nodes[i] : nullptr;
+        }
+
+        navigation_node &emplace( const tripoint_abs_omt &p ) {
+            block &b = *get_block( p, true );
+            const int i = index_in_block( p );
+            if( !b.known[i] ) {
+                b.known.set( i );
+                node_count++;
+            }
+            return b.nodes[i];
+        }
+
+    private:
+        static constexpr int block_size = 16;
+
+        struct block {
+            std::bitset<block_size * block_size> known;
+            std::array<navigation_node, block_size * block_size> nodes;
+        };
+
+        std::unordered_map<tripoint, block *> block_index;
+        // Blocks of this and earlier searches, the first used_blocks are in use
+        std::vector<std::unique_ptr<block>> blocks;
+        size_t used_blocks = 0;
+        size_t node_count = 0;
+        tripoint last_key;
+        block *last_block = nullptr;
+
+        static int block_of( const int v ) {
+            return v >= 0 ? v / block_size : ( v + 1 ) / block_size - 1;
+        }
+        static int index_in_block( const tripoint_abs_omt &p ) {
+            return ( p.y() - block_of( p.y() ) * block_size ) * block_size +
+                   p.x() - block_of( p.x() ) * block_size;
+        }
+
+        block *get_block( const tripoint_abs_omt &p, bool create ) {
+            const tripoint key( block_of( p.x() ), block_of( p.y() ), p.z() );
+            if( last_block != nullptr && key == last_key ) {
+                return last_block;
+            }
+            return find_block( key, create );
+        }
+        block *find_block( const tripoint &key, bool create );
+};
+
+// Everything a search allocates, for both of its ends
+struct search_state {
+    node_map known_nodes[2];
+    std::vector<scored_address> open_sets[2];
+};
+
+/**
+ * Search state of the calling thread, cleared and reused by each of its searches.
+ * Scoring functions must not start another search.
+ */
+search_state &get_search_state();
+
+} // namespace overmap_search
+
 /**
  * Uses A* to find an approximately-cheapest path from source to destination (in 3D).
+ * Long searches also search backwards from the destination until the two meet.
  *
  * @param source Starting point of path
  * @param dest End point of path
  * @param radius Maximum search radius
- * @param scorer function that returns the omt_score for the given OMT
+ * @param scorer function that returns the omt_score for the given OMT, it is called
+ * directly so that it can be inlined into the search
  * @param max_cost Maximum path cost (optional)
  */
+template<typename Scorer>
+simple_path<tripoint_abs_omt> find_overmap_path( const tripoint_abs_omt &source,
+        const tripoint_abs_omt &dest, const int radius, const Scorer &scorer,
+        cata::optional<int> max_cost = cata::nullopt )
+{
+    using namespace overmap_search;
+    constexpr size_t max_search_count = 100000;
+    simple_path<tripoint_abs_omt> ret;
+    bool meet = false;
+
+    const auto do_astar = [&]( const tripoint_abs_omt & start, node_map & known_nodes,
+                               std::vector<scored_address> &open_set,
+    node_map & other_known_nodes ) {
+        std::pop_heap( open_set.begin(), open_set.end(), std::greater<>() );
+        const tripoint_abs_omt cur_addr = open_set.back().addr;
+        open_set.pop_back();
+        if( other_known_nodes.find( cur_addr ) != nullptr ) {
+            meet = true;
+            tripoint_abs_omt addr = cur_addr;
+            tripoint_abs_omt other_start = start == source ? dest : source;
+            while( addr != other_start ) {
+                ret.points.emplace_back( addr );
+                addr = addr + direction_to_tripoint( other_known_nodes.find( addr )->get_prev_dir() );
+            }
+            ret.points.emplace_back( addr );
+            addr = cur_addr;
+            while( addr != start ) {
+                addr = addr + direction_to_tripoint( known_nodes.find( addr )->get_prev_dir() );
+                ret.points.emplace_back( addr );
+            }
+            return;
+        }
+        const navigation_node &cur_node = *known_nodes.find( cur_addr );
+        for( direction dir : enumerate_directions( cur_node.allow_z_change ) ) {
+            if( dir == cur_node.prev_dir ) {
+                continue; // don't go back the way we just came
+            }
+            const direction rev_dir = reverse_direction( dir );
+            const tripoint_abs_omt next_addr = cur_addr + direction_to_tripoint( dir );
+            const int cumulative_cost = cur_node.cumulative_cost + adjust_omt_cost( cur_node.node_cost, rev_dir,
+                                        cur_node.get_prev_dir() );
+            if( navigation_node *known = known_nodes.find( next_addr ) ) {
+                if( known->cumulative_cost > cumulative_cost ) {
+                    known->cumulative_cost = cumulative_cost;
+                    known->prev_dir = static_cast<int8_t>( rev_dir );
+                }
+            } else if( known_nodes.size() < max_search_count ) {
+                if( octile_dist( source.xy(), next_addr.xy() ) > radius ) {
+                    continue;
+                }
+                const omt_score next_score = scorer( next_addr );
+                if( next_score.node_cost < 0 ) {
+                    // TODO: add to closed set to avoid re-visiting
+                    continue;
+                }
+                // TODO: pass in the 10 (default terrain cost)
+                const int xy_score = octile_dist( next_addr.xy(), dest.xy(), 10 );
+                const int z_score = std::abs( next_addr.z() - dest.z() ) * 10;
+                const int estimated_total_cost = cumulative_cost + next_score.node_cost + xy_score + z_score;
+                if( max_cost && estimated_total_cost > *max_cost ) {
+                    continue;
+                }
+                navigation_node &next_node = known_nodes.emplace( next_addr );
+                next_node.cumulative_cost = cumulative_cost;
+                next_node.node_cost = next_score.node_cost;
+                next_node.prev_dir = static_cast<int8_t>( rev_dir );
+                next_node.allow_z_change = next_score.allow_z_change;
+                open_set.push_back( scored_address{ next_addr, estimated_total_cost } );
+                std::push_heap( open_set.begin(), open_set.end(), std::greater<>() );
+            }
+        }
+    };
+    const omt_score start_score = scorer( source );
+    const omt_score end_score = scorer( dest );
+    if( start_score.node_cost < 0 || end_score.node_cost < 0 ) {
+        return ret;
+    }
+    search_state &state = get_search_state();
+    node_map &known_nodes_src = state.known_nodes[0];
+    std::vector<scored_address> &open_set_src = state.open_sets[0];
+    known_nodes_src.clear();
+    open_set_src.clear();
+    known_nodes_src.emplace( source ) = navigation_node{0, 0, -1, start_score.allow_z_change};
+    open_set_src.push_back( scored_address{ source, 0 } );
+
+    node_map &known_nodes_dest = state.known_nodes[1];
+    std::vector<scored_address> &open_set_dest = state.open_sets[1];
+    known_nodes_dest.clear();
+    open_set_dest.clear();
+    known_nodes_dest.emplace( dest ) = navigation_node{0, 0, -1, end_score.allow_z_change};
+    open_set_dest.push_back( scored_address{ dest, 0 } );
+
+    int search_count = 0;
+    while( !open_set_src.empty() && !open_set_dest.empty() && !meet ) {
+        search_count++;
+        do_astar( source, known_nodes_src, open_set_src, known_nodes_dest );
+        if( meet ) {
+            return ret;
+        }
+        if( search_count > 10000 ) {
+            do_astar( dest, known_nodes_dest, open_set_dest, known_nodes_src );
+        }
+    }
+    return ret;
+}
+
+/**
+ * As above, for scoring functions that are only known at run time.
+ */
 simple_path<tripoint_abs_omt> find_overmap_path( const tripoint_abs_omt &source,
         const tripoint_abs_omt &dest, int radius, omt_scoring_fn scorer,
         cata::optional<int> max_cost = cata::nullopt );
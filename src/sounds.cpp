@@ -17,6 +17,7 @@
 #include "calendar.h"
 #include "coordinate_conversions.h"
 #include "creature.h"
+#include "creature_tracker.h"
 #include "debug.h"
 #include "effect.h"
 #include "enums.h"
@@ -28,6 +29,7 @@
 #include "line.h"
 #include "map.h"
 #include "map_iterator.h"
+#include "memory_fast.h"
 #include "messages.h"
 #include "monster.h"
 #include "npc.h"
@@ -322,13 +324,21 @@ void sounds::process_sounds()
             const tripoint_abs_sm target( abs_sm, source.z );
             overmap_buffer.signal_hordes( target, sig_power );
         }
+        if( vol <= 0 ) {
+            continue;
+        }
         // Alert all monsters (that can hear) to the sound.
-        for( monster &critter : g->all_monsters() ) {
+        // Only monsters within vol * 2 - 1 horizontally can pass the distance check below.
+        const int reach = vol * 2 - 1;
+        const std::vector<shared_ptr_fast<monster>> listeners = g->critter_tracker->find_in_cuboid(
+                    tripoint( source.xy() - point( reach, reach ), -OVERMAP_DEPTH ),
+                    tripoint( source.xy() + point( reach, reach ), OVERMAP_HEIGHT ) );
+        for( const shared_ptr_fast<monster> &critter : listeners ) {
             // TODO: Generalize this to Creature::hear_sound
-            const int dist = sound_distance( source, critter.pos() );
+            const int dist = sound_distance( source, critter->pos() );
             if( vol * 2 > dist ) {
                 // Exclude monsters that certainly won't hear the sound
-                critter.hear_sound( source, vol, dist );
+                critter->hear_sound( source, vol, dist );
             }
         }
     }
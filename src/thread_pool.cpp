@@ -0,0 +1,205 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+#if defined(_WIN32) && !defined(_MSC_VER) && !defined(_GLIBCXX_HAS_GTHREADS)
+// MinGW without gthreads has no std::mutex or std::condition_variable
+#   define THREAD_POOL_SINGLE_THREADED
+#else
+#   include <atomic>
+#   include <condition_variable>
+#   include <mutex>
+#   include <thread>
+#endif
+
+#include "cached_options.h"
+
+#if defined(THREAD_POOL_SINGLE_THREADED)
+
+namespace thread_pool
+{
+
+int concurrency()
+{
+    return 1;
+}
+
+void run( const size_t count, const std::function<void( size_t )> &task )
+{
+    for( size_t i = 0; i < count; ++i ) {
+        task( i );
+    }
+}
+
+} // namespace thread_pool
+
+#else
+
+namespace
+{
+
+// Set on pool threads and on the calling thread while it runs tasks
+thread_local bool running_task = false;
+
+class pool
+{
+    public:
+        pool() = default;
+        pool( const pool & ) = delete;
+        pool &operator=( const pool & ) = delete;
+
+        ~pool() {
+            resize( 0 );
+        }
+
+        static int wanted_concurrency() {
+            if( worker_threads > 0 ) {
+                return worker_threads;
+            }
+            return std::max( 1, static_cast<int>( std::thread::hardware_concurrency() ) );
+        }
+
+        void run( size_t count, const std::function<void( size_t )> &task ) {
+            resize( wanted_concurrency() - 1 );
+            if( workers.empty() || count <= 1 || running_task ) {
+                for( size_t i = 0; i < count; ++i ) {
+                    task( i );
+                }
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                current_task = &task;
+                task_count = count;
+                next_task.store( 0 );
+                finished_tasks.store( 0 );
+                first_error = nullptr;
+                generation++;
+            }
+            wake_workers.notify_all();
+
+            running_task = true;
+            work( task, count );
+            running_task = false;
+
+            std::unique_lock<std::mutex> lock( mutex );
+            // Workers that joined in have to leave before the task can go out of scope
+            all_done.wait( lock, [&] {
+                return finished_tasks.load() == count && busy_workers == 0;
+            } );
+            current_task = nullptr;
+            if( first_error ) {
+                std::exception_ptr error = first_error;
+                first_error = nullptr;
+                lock.unlock();
+                std::rethrow_exception( error );
+            }
+        }
+
+    private:
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable wake_workers;
+        std::condition_variable all_done;
+        bool quit = false;
+        unsigned generation = 0;
+        int busy_workers = 0;
+        const std::function<void( size_t )> *current_task = nullptr;
+        size_t task_count = 0;
+        std::exception_ptr first_error;
+
+        std::atomic<size_t> next_task{ 0 };
+        std::atomic<size_t> finished_tasks{ 0 };
+
+        void resize( int count ) {
+            if( static_cast<int>( workers.size() ) == count ) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                quit = true;
+            }
+            wake_workers.notify_all();
+            for( std::thread &worker : workers ) {
+                worker.join();
+            }
+            workers.clear();
+            quit = false;
+            for( int i = 0; i < count; ++i ) {
+                workers.emplace_back( [this] {
+                    worker_loop();
+                } );
+            }
+        }
+
+        void worker_loop() {
+            running_task = true;
+            std::unique_lock<std::mutex> lock( mutex );
+            unsigned seen_generation = generation;
+            while( true ) {
+                wake_workers.wait( lock, [&] {
+                    return quit || ( generation != seen_generation && current_task != nullptr );
+                } );
+                if( quit ) {
+                    return;
+                }
+                seen_generation = generation;
+                const std::function<void( size_t )> &task = *current_task;
+                const size_t count = task_count;
+                busy_workers++;
+                lock.unlock();
+                work( task, count );
+                lock.lock();
+                busy_workers--;
+                if( busy_workers == 0 ) {
+                    all_done.notify_all();
+                }
+            }
+        }
+
+        void work( const std::function<void( size_t )> &task, const size_t count ) {
+            for( size_t i = next_task.fetch_add( 1 ); i < count; i = next_task.fetch_add( 1 ) ) {
+                try {
+                    task( i );
+                } catch( ... ) {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    if( !first_error ) {
+                        first_error = std::current_exception();
+                    }
+                }
+                if( finished_tasks.fetch_add( 1 ) + 1 == count ) {
+                    std::lock_guard<std::mutex> lock( mutex );
+                    all_done.notify_all();
+                }
+            }
+        }
+};
+
+pool &get_pool()
+{
+    static pool instance;
+    return instance;
+}
+
+} // namespace
+
+namespace thread_pool
+{
+
+int concurrency()
+{
+    return pool::wanted_concurrency();
+}
+
+void run( const size_t count, const std::function<void( size_t )> &task )
+{
+    get_pool().run( count, task );
+}
+
+} // namespace thread_pool
+
+#endif // THREAD_POOL_SINGLE_THREADED
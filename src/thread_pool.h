@@ -0,0 +1,37 @@
+#pragma once
+#ifndef CATA_SRC_THREAD_POOL_H
+#define CATA_SRC_THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Worker threads shared by the passes that split their work into independent tasks,
+ * such as casting light and vision.
+ *
+ * Tasks are numbered and must not write to anything another task reads or writes.
+ * Callers that need a combined result give each task its own output and merge
+ * those in task order afterwards, so the outcome does not depend on the number of
+ * threads or on which thread ran which task.
+ *
+ * The number of threads is taken from @ref worker_threads on every @ref run call.
+ * MinGW builds without gthreads always run tasks on the calling thread.
+ */
+namespace thread_pool
+{
+
+/** Number of threads tasks can run on, including the calling one. */
+int concurrency();
+
+/**
+ * Calls task( i ) for every i in [0, count) and returns once all calls finished.
+ * Idle threads claim the next task that has not been started yet, and the calling
+ * thread takes part too. Everything runs on the calling thread if the pool is
+ * single-threaded, if there is only one task, or if called from within a task.
+ * If a task throws, the first exception is rethrown after all tasks finished.
+ */
+void run( size_t count, const std::function<void( size_t )> &task );
+
+} // namespace thread_pool
+
+#endif // CATA_SRC_THREAD_POOL_H
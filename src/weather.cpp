@@ -21,6 +21,7 @@
 #include "item.h"
 #include "item_contents.h"
 #include "map.h"
+#include "mapdata.h"
 #include "math_defines.h"
 #include "messages.h"
 #include "options.h"
@@ -937,6 +938,18 @@ int get_local_humidity( double humidity, const weather_type_id &weather, bool sh
 
 double get_local_windpower( double windpower, const oter_id &omter, const tripoint &location,
                             const int &winddirection, bool sheltered )
+{
+    return get_local_windpower( windpower, slows_wind( omter ), location, winddirection, sheltered );
+}
+
+bool slows_wind( const oter_id &omter )
+{
+    return is_ot_match( "forest", omter, ot_match_type::type ) ||
+           is_ot_match( "forest_water", omter, ot_match_type::type );
+}
+
+double get_local_windpower( double windpower, bool in_forest, const tripoint &location,
+                            const int &winddirection, bool sheltered )
 {
     /**
     *  A player is sheltered if he is underground, in a car, or indoors.
@@ -948,8 +961,7 @@ double get_local_windpower( double windpower, const oter_id &omter, const tripoi
     int tmpwind = static_cast<int>( windpower );
     tripoint triblocker( location + point( windvec.x, windvec.y ) );
     // Over map terrain may modify the effect of wind.
-    if( is_ot_match( "forest", omter, ot_match_type::type ) ||
-        is_ot_match( "forest_water", omter, ot_match_type::type ) ) {
+    if( in_forest ) {
         tmpwind = tmpwind / 2;
     }
     if( location.z > 0 ) {
@@ -964,7 +976,7 @@ double get_local_windpower( double windpower, const oter_id &omter, const tripoi
 
 bool is_wind_blocker( const tripoint &location )
 {
-    return g->m.has_flag( "BLOCK_WIND", location );
+    return g->m.has_flag( TFLAG_BLOCK_WIND, location );
 }
 
 // Description of Wind Speed - https://en.wikipedia.org/wiki/Beaufort_scale
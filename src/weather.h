@@ -120,6 +120,11 @@ int get_local_humidity( double humidity, const weather_type_id &weather, bool sh
 double get_local_windpower( double windpower, const oter_id &omter, const tripoint &location,
                             const int &winddirection,
                             bool sheltered = false );
+/** Same as above, with the overmap terrain already checked by @ref slows_wind. */
+double get_local_windpower( double windpower, bool in_forest, const tripoint &location,
+                            const int &winddirection, bool sheltered );
+/** Whether trees on this overmap terrain halve the wind. */
+bool slows_wind( const oter_id &omter );
 weather_sum sum_conditions( const time_point &start,
                             const time_point &end,
                             const tripoint &location );
@@ -0,0 +1,185 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "avatar.h"
+#include "creature.h"
+#include "creature_tracker.h"
+#include "game.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map_helpers.h"
+#include "memory_fast.h"
+#include "monster.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "units.h"
+
+static std::vector<const monster *> sorted( const std::vector<shared_ptr_fast<monster>> &mons )
+{
+    std::vector<const monster *> result;
+    for( const shared_ptr_fast<monster> &mon : mons ) {
+        result.push_back( mon.get() );
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<const monster *> brute_force_cuboid( const tripoint &min, const tripoint &max )
+{
+    std::vector<const monster *> result;
+    for( const monster &critter : g->all_monsters() ) {
+        const tripoint &p = critter.pos();
+        if( p.x >= min.x && p.y >= min.y && p.z >= min.z &&
+            p.x <= max.x && p.y <= max.y && p.z <= max.z ) {
+            result.push_back( &critter );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<const monster *> brute_force_radius( const tripoint &center, int radius )
+{
+    std::vector<const monster *> result;
+    for( const monster &critter : g->all_monsters() ) {
+        if( critter.posz() == center.z && rl_dist( critter.pos(), center ) <= radius ) {
+            result.push_back( &critter );
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static std::vector<const monster *> brute_force_cone( const tripoint &origin,
+        units::angle direction, units::angle spread, int range )
+{
+    std::vector<const monster *> result;
+    for( const monster &critter : g->all_monsters() ) {
+        if( critter.posz() != origin.z || critter.pos() == origin ||
+            rl_dist( critter.pos(), origin ) > range ) {
+            continue;
+        }
+        const units::angle bearing = coord_to_angle( origin, critter.pos() );
+        // Try the direction one turn either way too, so that it doesn't matter where 0 is
+        for( const units::angle dir : {
+                 direction - 360_degrees, direction, direction + 360_degrees
+             } ) {
+            if( units::fabs( bearing - dir ) * 2 <= spread ) {
+                result.push_back( &critter );
+                break;
+            }
+        }
+    }
+    std::sort( result.begin(), result.end() );
+    return result;
+}
+
+static void check_queries()
+{
+    const Creature_tracker &tracker = *g->critter_tracker;
+    for( const tripoint &center : {
+             tripoint( 5, 5, 0 ), tripoint( 30, 41, 0 ), tripoint( 60, 60, 0 ), tripoint( 130, 7, 0 )
+         } ) {
+        for( int radius : {
+                 0, 1, 6, 13, 40
+             } ) {
+            CAPTURE( center, radius );
+            const tripoint offset( radius, radius, 1 );
+            CHECK( sorted( tracker.find_in_cuboid( center - offset, center + offset ) ) ==
+                   brute_force_cuboid( center - offset, center + offset ) );
+            CHECK( sorted( tracker.find_in_radius( center, radius ) ) ==
+                   brute_force_radius( center, radius ) );
+            for( const units::angle direction : {
+                     0_degrees, 45_degrees, 200_degrees, 350_degrees
+                 } ) {
+                CAPTURE( units::to_degrees( direction ) );
+                CHECK( sorted( tracker.find_in_cone( center, direction, 60_degrees, radius ) ) ==
+                       brute_force_cone( center, direction, 60_degrees, radius ) );
+            }
+
+            std::vector<const Creature *> near;
+            for( Creature &critter : g->creatures_in_range( center, radius ) ) {
+                near.push_back( &critter );
+            }
+            std::sort( near.begin(), near.end() );
+            std::vector<const Creature *> expected;
+            for( Creature &critter : g->all_creatures() ) {
+                if( square_dist( critter.pos(), center ) <= radius ) {
+                    expected.push_back( &critter );
+                }
+            }
+            std::sort( expected.begin(), expected.end() );
+            CHECK( near == expected );
+        }
+    }
+}
+
+TEST_CASE( "creature_tracker_spatial_queries_follow_monsters", "[creature_tracker]" )
+{
+    clear_all_state();
+    std::vector<monster *> mons;
+    for( int x = 3; x < 120; x += 7 ) {
+        for( int y = 3; y < 120; y += 11 ) {
+            mons.push_back( &spawn_test_monster( "mon_zombie", tripoint( x, y, 0 ) ) );
+        }
+    }
+    check_queries();
+
+    SECTION( "after monsters moved" ) {
+        for( size_t i = 0; i < mons.size(); i += 3 ) {
+            mons[i]->setpos( mons[i]->pos() + point( 5, 4 ) );
+        }
+        check_queries();
+    }
+    SECTION( "after monsters swapped places" ) {
+        for( size_t i = 0; i + 1 < mons.size(); i += 4 ) {
+            g->swap_critters( *mons[i], *mons[mons.size() - 1 - i] );
+        }
+        check_queries();
+    }
+    SECTION( "after monsters were removed" ) {
+        for( size_t i = 0; i < mons.size(); i += 2 ) {
+            g->remove_zombie( *mons[i] );
+        }
+        check_queries();
+        for( monster &critter : g->all_monsters() ) {
+            CHECK( g->critter_tracker->find_in_radius( critter.pos(), 0 ).size() == 1 );
+        }
+    }
+}
+
+TEST_CASE( "creature_range_query_benchmark", "[.][creature_tracker][benchmark]" )
+{
+    clear_all_state();
+    // 1200 monsters spread over the reality bubble
+    for( int x = 2; x < MAPSIZE_X - 2; x += 4 ) {
+        for( int y = 2; y < MAPSIZE_Y - 2; y += 3 ) {
+            if( g->critter_tracker->size() < 1200 ) {
+                spawn_test_monster( "mon_zombie", tripoint( x, y, 0 ) );
+            }
+        }
+    }
+    REQUIRE( g->critter_tracker->size() >= 1000 );
+    const tripoint center( 60, 60, 0 );
+    const int range = 10;
+
+    BENCHMARK( "all creatures, filtered" ) {
+        return g->get_creatures_if( [&]( const Creature & critter ) {
+            return rl_dist( critter.pos(), center ) <= range;
+        } ).size();
+    };
+    BENCHMARK( "creatures in range" ) {
+        return g->get_creatures_in_range_if( center, range, [&]( const Creature & critter ) {
+            return rl_dist( critter.pos(), center ) <= range;
+        } ).size();
+    };
+    BENCHMARK( "monsters in cone" ) {
+        return g->critter_tracker->find_in_cone( center, 90_degrees, 45_degrees, range ).size();
+    };
+    BENCHMARK( "visible creatures" ) {
+        return get_avatar().get_visible_creatures( range ).size();
+    };
+}
@@ -0,0 +1,87 @@
+#include "catch/catch.hpp"
+
+#include <array>
+
+#include "avatar.h"
+#include "cached_options.h"
+#include "calendar.h"
+#include "game.h"
+#include "game_constants.h"
+#include "map_helpers.h"
+#include "monster.h"
+#include "point.h"
+#include "rng.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static const efftype_id effect_sleep( "sleep" );
+
+TEST_CASE( "fast_forward_stops_when_a_hostile_comes_near", "[game][fast_forward]" )
+{
+    clear_all_state();
+    const bool old_fast_forward = fast_forward;
+    fast_forward = true;
+    avatar &you = get_avatar();
+    you.setpos( tripoint( 60, 60, 0 ) );
+    // Awake and idle
+    CHECK_FALSE( g->can_fast_forward() );
+
+    you.add_effect( effect_sleep, 8_hours );
+    CHECK( g->can_fast_forward() );
+
+    SECTION( "hostile out of sight" ) {
+        spawn_test_monster( "mon_zombie", tripoint( 100, 60, 0 ) );
+        CHECK_FALSE( g->can_fast_forward() );
+    }
+    SECTION( "hostile far away" ) {
+        spawn_test_monster( "mon_zombie", tripoint( 60, 60 + MAX_VIEW_DISTANCE + 1, 0 ) );
+        CHECK( g->can_fast_forward() );
+    }
+    SECTION( "pet next to the player" ) {
+        monster &dog = spawn_test_monster( "mon_dog", tripoint( 61, 60, 0 ) );
+        dog.friendly = -1;
+        CHECK( g->can_fast_forward() );
+    }
+    SECTION( "woken up" ) {
+        you.remove_effect( effect_sleep );
+        CHECK_FALSE( g->can_fast_forward() );
+    }
+    SECTION( "turned off" ) {
+        fast_forward = false;
+        CHECK_FALSE( g->can_fast_forward() );
+    }
+    fast_forward = old_fast_forward;
+}
+
+// Stamina, stored kcal and thirst after a few minutes of sleep
+static std::array<int, 3> body_after_sleeping( const bool fast )
+{
+    clear_all_state();
+    fast_forward = fast;
+    calendar::turn = calendar::turn_zero + 12_hours;
+    avatar &you = get_avatar();
+    you.setpos( tripoint( 60, 60, 0 ) );
+    you.add_effect( effect_sleep, 8_hours );
+    you.set_stamina( you.get_stamina_max() / 10 );
+    rng_set_engine_seed( 1234 );
+    for( int i = 0; i < to_turns<int>( 6_minutes ); i++ ) {
+        calendar::turn += 1_turns;
+        g->update_player_body();
+    }
+    return {{ you.get_stamina(), you.get_stored_kcal(), you.get_thirst() }};
+}
+
+TEST_CASE( "fast_forward_keeps_the_body_in_step", "[game][fast_forward]" )
+{
+    const bool old_fast_forward = fast_forward;
+    const std::array<int, 3> per_turn = body_after_sleeping( false );
+    const std::array<int, 3> fast_forwarded = body_after_sleeping( true );
+    fast_forward = old_fast_forward;
+
+    const int start_stamina = get_avatar().get_stamina_max() / 10;
+    CHECK( per_turn[0] > start_stamina );
+    CHECK( per_turn[0] < get_avatar().get_stamina_max() );
+    CHECK( fast_forwarded[0] == per_turn[0] );
+    CHECK( fast_forwarded[1] == per_turn[1] );
+    CHECK( fast_forwarded[2] == per_turn[2] );
+}
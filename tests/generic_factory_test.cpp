@@ -108,6 +108,30 @@ TEST_CASE( "generic_factory_repeated_invalidation", "[generic_factory]" )
     }
 }
 
+TEST_CASE( "generic_factory_lookup_after_finalize", "[generic_factory]" )
+{
+    generic_factory<test_obj> test_factory( "test_factory" );
+    for( int i = 0; i < 1000; ++i ) {
+        test_factory.insert( { test_obj_id( "id_" + std::to_string( i ) ), "value_" + std::to_string( i ) } );
+    }
+    test_factory.finalize();
+
+    // fresh ids, without a cached int id
+    for( int i = 0; i < 1000; ++i ) {
+        const test_obj_id id( "id_" + std::to_string( i ) );
+        REQUIRE( test_factory.is_valid( id ) );
+        CHECK( test_factory.obj( test_obj_id( "id_" + std::to_string( i ) ) ).value ==
+               "value_" + std::to_string( i ) );
+    }
+    CHECK_FALSE( test_factory.is_valid( test_obj_id( "id_1000" ) ) );
+    CHECK_FALSE( test_factory.is_valid( test_obj_id( "" ) ) );
+
+    // changes after finalization are still visible
+    test_factory.insert( { test_obj_id( "id_1000" ), "value_1000" } );
+    CHECK( test_factory.is_valid( test_obj_id( "id_1000" ) ) );
+    CHECK( test_factory.obj( test_obj_id( "id_5" ) ).value == "value_5" );
+}
+
 TEST_CASE( "generic_factory_common_null_ids", "[generic_factory]" )
 {
     CHECK( field_type_str_id::NULL_ID().is_null() );
@@ -204,6 +228,31 @@ TEST_CASE( "generic_factory_lookup_benchmark", "[.][generic_factory][benchmark]"
     BENCHMARK( "single lookup" ) {
         return test_factory.obj( id_200 ).value;
     };
+
+    // Ids without a cached int id, like temporaries or ids read from a save.
+    std::vector<test_obj_id> ids;
+    for( int i = 0; i < 1000; ++i ) {
+        ids.emplace_back( "id_" + std::to_string( i * 7 % 1000 ) );
+    }
+    const auto lookup_fresh_ids = [&]() {
+        size_t valid = 0;
+        for( const test_obj_id &id : ids ) {
+            // only the copy caches the int id, the original stays uncached
+            const test_obj_id fresh( id );
+            valid += test_factory.is_valid( fresh ) ? 1 : 0;
+        }
+        return valid;
+    };
+    BENCHMARK( "fresh ids, before finalize" ) {
+        return lookup_fresh_ids();
+    };
+    test_factory.finalize();
+    BENCHMARK( "fresh ids, after finalize" ) {
+        return lookup_fresh_ids();
+    };
+    BENCHMARK( "fresh id obj(), after finalize" ) {
+        return test_factory.obj( test_obj_id( ids[0] ) ).value;
+    };
 }
 
 TEST_CASE( "string_id_compare_benchmark", "[.][generic_factory][string_id][benchmark]" )
@@ -1,11 +1,16 @@
 #include "catch/catch.hpp"
 
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <sstream>
 
 #include "bodypart.h"
 #include "json.h"
+#include "mapdata.h"
 #include "string_formatter.h"
+#include "submap.h"
 #include "type_id.h"
 #include "colony.h"
 
@@ -62,6 +67,43 @@ TEST_CASE( "serialize_sequences", "[json]" )
     test_serialization( l, R"(["foo","bar"])" );
 }
 
+TEST_CASE( "serialize_numbers", "[json]" )
+{
+    test_serialization( 0, "0" );
+    test_serialization( -42, "-42" );
+    test_serialization( std::numeric_limits<int64_t>::min(), "-9223372036854775808" );
+    test_serialization( std::numeric_limits<uint64_t>::max(), "18446744073709551615" );
+    test_serialization( true, "true" );
+
+    // Floating point values are only checked for their output, reading them back is not exact.
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_array();
+    jsout.write( 1.5 );
+    jsout.write( -0.25f );
+    jsout.write( 1e20 );
+    jsout.write( 0.0000004 );
+    jsout.end_array();
+    CHECK( os.str() == "[1.500000,-0.250000,100000000000000000000.000000,0.000000]" );
+}
+
+TEST_CASE( "jsonout_output_reaches_stream", "[json]" )
+{
+    std::ostringstream os;
+    JsonOut jsout( os );
+    jsout.start_object();
+    jsout.member( "a", 1 );
+    jsout.write_newline();
+    // Direct access to the stream gets everything written so far.
+    CHECK( jsout.get_stream()->tellp() == 7 );
+    jsout.member( "b" );
+    jsout.start_array();
+    jsout.end_array();
+    jsout.end_object();
+    // Complete top-level values are visible without an explicit flush.
+    CHECK( os.str() == "{\"a\":1\n,\"b\":[]}" );
+}
+
 TEST_CASE( "serialize_set", "[json]" )
 {
     std::set<std::string> s_set = { "foo", "bar" };
@@ -243,18 +285,30 @@ TEST_CASE( "translation_text_style_check_error_recovery", "[json][translation]"
 static void test_get_string( const std::string &str, const std::string &json )
 {
     CAPTURE( json );
-    std::istringstream iss( json );
-    JsonIn jsin( iss );
-    CHECK( jsin.get_string() == str );
+    {
+        std::istringstream iss( json );
+        JsonIn jsin( iss );
+        CHECK( jsin.get_string() == str );
+    }
+    {
+        JsonIn jsin( json.data(), json.size() );
+        CHECK( jsin.get_string() == str );
+    }
 }
 
 template<typename Matcher>
 static void test_get_string_throws_matches( Matcher &&matcher, const std::string &json )
 {
     CAPTURE( json );
-    std::istringstream iss( json );
-    JsonIn jsin( iss );
-    CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    {
+        std::istringstream iss( json );
+        JsonIn jsin( iss );
+        CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    }
+    {
+        JsonIn jsin( json.data(), json.size() );
+        CHECK_THROWS_MATCHES( jsin.get_string(), JsonError, matcher );
+    }
 }
 
 template<typename Matcher>
@@ -263,9 +317,15 @@ static void test_string_error_throws_matches( Matcher &&matcher, const std::stri
 {
     CAPTURE( json );
     CAPTURE( offset );
-    std::istringstream iss( json );
-    JsonIn jsin( iss );
-    CHECK_THROWS_MATCHES( jsin.string_error( "<message>", offset ), JsonError, matcher );
+    {
+        std::istringstream iss( json );
+        JsonIn jsin( iss );
+        CHECK_THROWS_MATCHES( jsin.string_error( "<message>", offset ), JsonError, matcher );
+    }
+    {
+        JsonIn jsin( json.data(), json.size() );
+        CHECK_THROWS_MATCHES( jsin.string_error( "<message>", offset ), JsonError, matcher );
+    }
 }
 
 TEST_CASE( "jsonin_get_string", "[json]" )
@@ -452,3 +512,110 @@ TEST_CASE( "jsonin_get_string", "[json]" )
             R"(       ar")" "\n" ),
         R"("foo\nbar")", 5 );
 }
+
+TEST_CASE( "jsonin_memory_matches_stream", "[json]" )
+{
+    const std::string json =
+        R"({ "a": [ 1, -0.5e3, 12E+2, true, null ], "b": { "c": "d\u2026e" }, "f": "g" })";
+    std::istringstream iss( json );
+    JsonIn stream_jsin( iss );
+    JsonIn memory_jsin( json.data(), json.size() );
+    JsonObject stream_obj = stream_jsin.get_object();
+    JsonObject memory_obj = memory_jsin.get_object();
+    CHECK( stream_obj.get_array( "a" ).get_float( 1 ) == memory_obj.get_array( "a" ).get_float( 1 ) );
+    CHECK( stream_obj.get_array( "a" ).get_int( 2 ) == memory_obj.get_array( "a" ).get_int( 2 ) );
+    CHECK( stream_obj.get_object( "b" ).get_string( "c" ) ==
+           memory_obj.get_object( "b" ).get_string( "c" ) );
+    CHECK( stream_obj.get_string( "f" ) == memory_obj.get_string( "f" ) );
+    CHECK( stream_jsin.tell() == memory_jsin.tell() );
+}
+
+static void walk_json( JsonIn &jsin )
+{
+    if( jsin.test_object() ) {
+        jsin.start_object();
+        while( !jsin.end_object() ) {
+            jsin.get_member_name();
+            walk_json( jsin );
+        }
+    } else if( jsin.test_array() ) {
+        jsin.start_array();
+        while( !jsin.end_array() ) {
+            walk_json( jsin );
+        }
+    } else if( jsin.test_string() ) {
+        jsin.get_string();
+    } else if( jsin.test_number() ) {
+        jsin.get_float();
+    } else {
+        jsin.skip_value();
+    }
+}
+
+TEST_CASE( "json_parse_benchmark", "[.][json][benchmark]" )
+{
+    std::ifstream fin( "data/json/mutations/mutations.json", std::ios::binary );
+    REQUIRE( fin.good() );
+    const std::string data( ( std::istreambuf_iterator<char>( fin ) ),
+                            std::istreambuf_iterator<char>() );
+
+    BENCHMARK( "parse from stream" ) {
+        std::istringstream iss( data );
+        JsonIn jsin( iss );
+        walk_json( jsin );
+        return jsin.tell();
+    };
+    BENCHMARK( "parse from memory" ) {
+        JsonIn jsin( data.data(), data.size() );
+        walk_json( jsin );
+        return jsin.tell();
+    };
+}
+
+TEST_CASE( "json_save_benchmark", "[.][json][benchmark]" )
+{
+    // A set of submaps with varied terrain, stored the same way as the map buffer does it.
+    std::vector<submap> submaps( 100 );
+    const int ter_count = static_cast<int>( ter_t::count() );
+    const int furn_count = static_cast<int>( furn_t::count() );
+    for( size_t n = 0; n < submaps.size(); n++ ) {
+        for( int x = 0; x < SEEX; x++ ) {
+            for( int y = 0; y < SEEY; y++ ) {
+                const int hash = static_cast<int>( n ) * 31 + x * 7 + y / 3;
+                submaps[n].set_ter( point( x, y ), ter_id( hash % ter_count ) );
+                submaps[n].set_furn( point( x, y ), furn_id( hash % 5 == 0 ? hash % furn_count : 0 ) );
+                submaps[n].set_radiation( point( x, y ), hash % 4 );
+            }
+        }
+    }
+
+    BENCHMARK( "store submaps" ) {
+        std::ostringstream os;
+        JsonOut jsout( os );
+        jsout.start_array();
+        for( size_t n = 0; n < submaps.size(); n++ ) {
+            jsout.start_object();
+            jsout.member( "coordinates" );
+            jsout.start_array();
+            jsout.write( static_cast<int>( n ) );
+            jsout.write( 0 );
+            jsout.write( 0 );
+            jsout.end_array();
+            submaps[n].store( jsout );
+            jsout.end_object();
+        }
+        jsout.end_array();
+        return os.str().size();
+    };
+    BENCHMARK( "write numbers" ) {
+        std::ostringstream os;
+        JsonOut jsout( os );
+        jsout.start_array();
+        for( int i = 0; i < 100000; i++ ) {
+            jsout.write( i * 37 % 2000 - 1000 );
+            jsout.write( i * 0.125 );
+        }
+        jsout.end_array();
+        return os.str().size();
+    };
+}
@@ -0,0 +1,219 @@
+#include <cstdio>
+#include "catch/catch.hpp"
+
+#include <cstring>
+#include <vector>
+
+#include "avatar.h"
+#include "cached_options.h"
+#include "calendar.h"
+#include "game_constants.h"
+#include "map.h"
+#include "point.h"
+#include "shadowcasting.h"
+#include "state_helpers.h"
+#include "type_id.h"
+#include "vehicle.h"
+
+// A grid of 12x12 walled blocks with a door in the middle of every wall and lamps inside.
+// Returns the door positions.
+static std::vector<tripoint> build_lit_city( int lamps_per_block )
+{
+    const ter_id t_brick_wall( "t_brick_wall" );
+    const ter_id t_door_c( "t_door_c" );
+    const ter_id t_floor( "t_floor" );
+    const ter_id t_utility_light( "t_utility_light" );
+
+    map &here = get_map();
+    std::vector<tripoint> doors;
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            const tripoint p( x, y, 0 );
+            const bool wall_x = x % 12 == 0;
+            const bool wall_y = y % 12 == 0;
+            if( wall_x != wall_y && ( x % 12 == 6 || y % 12 == 6 ) ) {
+                here.ter_set( p, t_door_c );
+                doors.push_back( p );
+            } else if( wall_x || wall_y ) {
+                here.ter_set( p, t_brick_wall );
+            } else {
+                here.ter_set( p, t_floor );
+            }
+        }
+    }
+    for( int bx = 0; bx + 12 < MAPSIZE_X; bx += 12 ) {
+        for( int by = 0; by + 12 < MAPSIZE_Y; by += 12 ) {
+            for( int i = 0; i < lamps_per_block; ++i ) {
+                here.ter_set( tripoint( bx + 2 + 3 * ( i % 3 ), by + 2 + 3 * ( i / 3 % 3 ), 0 ),
+                              t_utility_light );
+            }
+        }
+    }
+    return doors;
+}
+
+static void toggle_door( const tripoint &p )
+{
+    map &here = get_map();
+    if( here.ter( p ) == ter_id( "t_door_c" ) ) {
+        here.ter_set( p, ter_id( "t_door_o" ) );
+    } else {
+        here.ter_set( p, ter_id( "t_door_c" ) );
+    }
+}
+
+// Compares the lightmap built from the bulk light cache with one cast from scratch
+static void check_matches_full_rebuild()
+{
+    map &here = get_map();
+    level_cache &cache = here.access_cache( 0 );
+    std::vector<four_quadrants> incremental( &cache.lm[0][0], &cache.lm[0][0] + MAPSIZE_X * MAPSIZE_Y );
+    std::vector<float> incremental_sm( &cache.sm[0][0], &cache.sm[0][0] + MAPSIZE_X * MAPSIZE_Y );
+    cache.bulk_lights.valid = false;
+    here.build_map_cache( 0 );
+    CHECK( std::memcmp( incremental.data(), cache.lm, sizeof( cache.lm ) ) == 0 );
+    CHECK( std::memcmp( incremental_sm.data(), cache.sm, sizeof( cache.sm ) ) == 0 );
+}
+
+TEST_CASE( "bulk_light_cache_matches_full_rebuild", "[shadowcasting][lightmap]" )
+{
+    clear_all_state();
+    calendar::turn = calendar::turn_zero;
+    map &here = get_map();
+    const std::vector<tripoint> doors = build_lit_city( 3 );
+    here.build_map_cache( 0 );
+    level_cache &cache = here.access_cache( 0 );
+    REQUIRE( cache.bulk_lights.valid );
+
+    here.build_map_cache( 0 );
+    CHECK( cache.bulk_lights.sources_cast == 0 );
+
+    for( size_t i = 0; i < doors.size(); i += 7 ) {
+        toggle_door( doors[i] );
+        here.ter_set( doors[i] + point( 1, 1 ), ter_id( "t_utility_light" ) );
+        here.build_map_cache( 0 );
+        CHECK( cache.bulk_lights.sources_cast > 0 );
+        check_matches_full_rebuild();
+    }
+}
+
+TEST_CASE( "bulk_light_cache_follows_vehicles_and_distance_metric", "[shadowcasting][lightmap]" )
+{
+    clear_all_state();
+    fprintf( stderr, "STEP 1\n" );
+    calendar::turn = calendar::turn_zero;
+    fprintf( stderr, "STEP 2\n" );
+    map &here = get_map();
+    fprintf( stderr, "STEP 3\n" );
+    build_lit_city( 3 );
+    fprintf( stderr, "STEP 4\n" );
+    here.build_map_cache( 0 );
+    fprintf( stderr, "STEP 5\n" );
+    level_cache &cache = here.access_cache( 0 );
+    fprintf( stderr, "STEP 6\n" );
+
+    // Turned diagonally, so that it obscures tiles between its parts
+    vehicle *veh = here.add_vehicle( vproto_id( "apc" ), tripoint( 66, 40, 0 ), -45_degrees, 0, 0 );
+    fprintf( stderr, "STEP 7\n" );
+    REQUIRE( veh != nullptr );
+    fprintf( stderr, "STEP 8\n" );
+    for( vehicle_part *light : veh->lights( false ) ) {
+        light->enabled = true;
+    }
+    REQUIRE( !veh->lights( true ).empty() );
+    fprintf( stderr, "STEP 9\n" );
+    here.build_map_cache( 0 );
+    fprintf( stderr, "STEP 10\n" );
+    CHECK( cache.bulk_lights.sources_cast > 0 );
+    fprintf( stderr, "STEP 11\n" );
+    check_matches_full_rebuild();
+    fprintf( stderr, "STEP 12\n" );
+
+    // One tile at a time, like a vehicle driving
+    for( int i = 0; i < 5; i++ ) {
+        REQUIRE( here.displace_vehicle( *veh, tripoint_south_east ) );
+    }
+    here.build_map_cache( 0 );
+    fprintf( stderr, "STEP 13\n" );
+    CHECK( cache.bulk_lights.sources_cast > 0 );
+    fprintf( stderr, "STEP 14\n" );
+    check_matches_full_rebuild();
+    fprintf( stderr, "STEP 15\n" );
+
+    // Switching the distance metric changes every source's shape
+    const int all_sources = cache.bulk_lights.sources_cast;
+    fprintf( stderr, "STEP 16\n" );
+    const bool old_trigdist = trigdist;
+    fprintf( stderr, "STEP 17\n" );
+    trigdist = !trigdist;
+    fprintf( stderr, "STEP 18\n" );
+    here.build_map_cache( 0 );
+    fprintf( stderr, "STEP 19\n" );
+    CHECK( cache.bulk_lights.sources_cast == all_sources );
+    fprintf( stderr, "STEP 20\n" );
+    check_matches_full_rebuild();
+    fprintf( stderr, "STEP 21\n" );
+    trigdist = old_trigdist;
+    fprintf( stderr, "STEP 22\n" );
+}
+
+TEST_CASE( "threaded_light_and_vision_match_single_threaded", "[shadowcasting][lightmap]" )
+{
+    clear_all_state();
+    calendar::turn = calendar::turn_zero;
+    map &here = get_map();
+    build_lit_city( 9 );
+    get_avatar().setpos( tripoint( 65, 65, 0 ) );
+
+    const int old_worker_threads = worker_threads;
+    const bool old_fov_3d = fov_3d;
+    fov_3d = true;
+    std::vector<float> seen[2];
+    std::vector<four_quadrants> lm[2];
+    for( int run = 0; run < 2; ++run ) {
+        worker_threads = run == 0 ? 1 : 4;
+        level_cache &cache = here.access_cache( 0 );
+        cache.bulk_lights.valid = false;
+        cache.seen_cache_dirty = true;
+        here.build_map_cache( 0 );
+        CHECK( cache.bulk_lights.sources_cast >= 900 );
+        lm[run].assign( &cache.lm[0][0], &cache.lm[0][0] + MAPSIZE_X * MAPSIZE_Y );
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+            const level_cache &level = here.access_cache( z );
+            seen[run].insert( seen[run].end(), &level.seen_cache[0][0],
+                              &level.seen_cache[0][0] + MAPSIZE_X * MAPSIZE_Y );
+        }
+    }
+    worker_threads = old_worker_threads;
+    fov_3d = old_fov_3d;
+
+    CHECK( std::memcmp( lm[0].data(), lm[1].data(), lm[0].size() * sizeof( four_quadrants ) ) == 0 );
+    CHECK( seen[0] == seen[1] );
+}
+
+TEST_CASE( "lightmap_benchmark", "[.][lightmap][benchmark]" )
+{
+    clear_all_state();
+    calendar::turn = calendar::turn_zero;
+    map &here = get_map();
+    // 100 blocks, 4 lamps each
+    const std::vector<tripoint> doors = build_lit_city( 4 );
+    here.build_map_cache( 0 );
+    level_cache &cache = here.access_cache( 0 );
+
+    BENCHMARK( "nothing changed" ) {
+        here.build_map_cache( 0 );
+        return cache.lm[60][60].max();
+    };
+    size_t next_door = 0;
+    BENCHMARK( "one door toggled" ) {
+        toggle_door( doors[next_door++ % doors.size()] );
+        here.build_map_cache( 0 );
+        return cache.lm[60][60].max();
+    };
+    BENCHMARK( "full rebuild" ) {
+        cache.bulk_lights.valid = false;
+        here.build_map_cache( 0 );
+        return cache.lm[60][60].max();
+    };
+}
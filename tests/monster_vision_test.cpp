@@ -1,14 +1,20 @@
 #include "catch/catch.hpp"
 
 #include <memory>
+#include <vector>
 
+#include "cached_options.h"
 #include "calendar.h"
 #include "game.h"
 #include "map.h"
 #include "map_helpers.h"
+#include "map_iterator.h"
 #include "mapdata.h"
 #include "monster.h"
+#include "npc.h"
 #include "options_helpers.h"
+#include "player_helpers.h"
+#include "rng.h"
 #include "state_helpers.h"
 
 struct tripoint;
@@ -102,3 +108,177 @@ TEST_CASE( "monsters_dont_see_through_vehicle_holes", "[vision]" )
     CHECK( !outside.sees( inside ) );
 
 }
+
+TEST_CASE( "visibility_targets_are_seen_like_without_them", "[vision]" )
+{
+    clear_all_state();
+    calendar::turn = midday;
+    map &here = get_map();
+    const tripoint target( 60, 60, 0 );
+    for( int x = 50; x <= 70; ++x ) {
+        here.ter_set( tripoint( x, 55, 0 ), t_wall );
+    }
+    here.build_map_cache( 0 );
+
+    const std::vector<tripoint> in_view = { { 60, 65, 0 }, { 70, 60, 0 }, { 52, 68, 0 }, { 60, 56, 0 } };
+    const std::vector<tripoint> out_of_view = { { 60, 50, 0 }, { 58, 52, 0 }, { 69, 54, 0 } };
+    for( bool use_field : {
+             false, true
+         } ) {
+        CAPTURE( use_field );
+        here.clear_visibility_targets();
+        if( use_field ) {
+            here.add_visibility_target( target );
+            here.begin_target_sight_checks();
+        }
+        for( const tripoint &p : in_view ) {
+            CAPTURE( p );
+            CHECK( here.sees( p, target, 60 ) );
+        }
+        for( const tripoint &p : out_of_view ) {
+            CAPTURE( p );
+            CHECK_FALSE( here.sees( p, target, 60 ) );
+        }
+        CHECK_FALSE( here.sees( { 60, 65, 0 }, target, 4 ) );
+    }
+
+    // The field follows changes to the map once the cache is rebuilt
+    CHECK( here.sees( { 60, 65, 0 }, target, 60 ) );
+    for( int x = 50; x <= 70; ++x ) {
+        here.ter_set( tripoint( x, 63, 0 ), t_wall );
+    }
+    here.build_map_cache( 0 );
+    CHECK_FALSE( here.sees( { 60, 65, 0 }, target, 60 ) );
+    here.end_target_sight_checks();
+    here.clear_visibility_targets();
+}
+
+TEST_CASE( "visibility_targets_only_apply_to_target_sight_checks", "[vision]" )
+{
+    clear_all_state();
+    calendar::turn = midday;
+    map &here = get_map();
+    const tripoint target( 60, 60, 0 );
+    // A pillar that hides the target from some tiles behind it
+    here.ter_set( tripoint( 62, 61, 0 ), t_wall );
+    here.build_map_cache( 0 );
+
+    std::vector<bool> traced;
+    for( const tripoint &p : here.points_in_radius( target, 10 ) ) {
+        traced.push_back( here.sees( p, target, 60 ) );
+    }
+    here.add_visibility_target( target );
+    std::vector<bool> registered;
+    for( const tripoint &p : here.points_in_radius( target, 10 ) ) {
+        registered.push_back( here.sees( p, target, 60 ) );
+    }
+    here.clear_visibility_targets();
+
+    CHECK( registered == traced );
+}
+
+// Where the monsters end up after a few turns among pillars and NPCs
+static std::vector<tripoint> horde_moves_for_a_few_turns()
+{
+    clear_all_state();
+    calendar::turn = midday;
+    map &here = get_map();
+    for( int x = 3; x < MAPSIZE_X; x += 7 ) {
+        for( int y = 2; y < MAPSIZE_Y; y += 5 ) {
+            here.ter_set( tripoint( x, y, 0 ), t_wall );
+        }
+    }
+    for( int i = 0; i < 4; ++i ) {
+        spawn_npc( point( 50 + 7 * i, 60 + i % 2 ), "test_talker" );
+    }
+    for( int x = 30; x < 100; x += 5 ) {
+        for( int y = 20; y < 100; y += 6 ) {
+            if( here.passable( tripoint( x, y, 0 ) ) && g->is_empty( tripoint( x, y, 0 ) ) ) {
+                spawn_test_monster( "mon_zombie", tripoint( x, y, 0 ) );
+            }
+        }
+    }
+    here.build_map_cache( 0 );
+
+    rng_set_engine_seed( 42 );
+    for( int turn = 0; turn < 5; ++turn ) {
+        for( monster &critter : g->all_monsters() ) {
+            critter.mod_moves( critter.get_speed() );
+        }
+        g->monmove();
+    }
+    std::vector<tripoint> result;
+    for( const monster &critter : g->all_monsters() ) {
+        result.push_back( critter.pos() );
+    }
+    return result;
+}
+
+TEST_CASE( "monster_plans_match_for_any_thread_count", "[vision][monster]" )
+{
+    const int old_worker_threads = worker_threads;
+    const bool old_parallel_monster_planning = parallel_monster_planning;
+    parallel_monster_planning = true;
+    worker_threads = 1;
+    const std::vector<tripoint> single_threaded = horde_moves_for_a_few_turns();
+    worker_threads = 4;
+    const std::vector<tripoint> multi_threaded = horde_moves_for_a_few_turns();
+    worker_threads = old_worker_threads;
+    parallel_monster_planning = old_parallel_monster_planning;
+
+    CHECK( single_threaded.size() > 100 );
+    CHECK( single_threaded == multi_threaded );
+}
+
+TEST_CASE( "monster_vision_benchmark", "[.][vision][benchmark]" )
+{
+    clear_all_state();
+    calendar::turn = midday;
+    map &here = get_map();
+    // Pillars to break up lines of sight
+    for( int x = 3; x < MAPSIZE_X; x += 7 ) {
+        for( int y = 2; y < MAPSIZE_Y; y += 5 ) {
+            here.ter_set( tripoint( x, y, 0 ), t_wall );
+        }
+    }
+    std::vector<npc *> npcs;
+    for( int i = 0; i < 10; ++i ) {
+        npcs.push_back( &spawn_npc( point( 40 + 5 * i, 60 + i % 2 ), "test_talker" ) );
+    }
+    std::vector<monster *> horde;
+    for( int x = 20; x < 120 && horde.size() < 1000; x += 2 ) {
+        for( int y = 10; y < 120 && horde.size() < 1000; y += 3 ) {
+            if( here.passable( tripoint( x, y, 0 ) ) && g->is_empty( tripoint( x, y, 0 ) ) ) {
+                horde.push_back( &spawn_test_monster( "mon_zombie", tripoint( x, y, 0 ) ) );
+            }
+        }
+    }
+    REQUIRE( horde.size() == 1000 );
+
+    // One turn's worth of target checks, with the caches dropped as if the map changed
+    const auto horde_looks_at_npcs = [&]() {
+        here.set_seen_cache_dirty( 0 );
+        here.build_map_cache( 0 );
+        int seen = 0;
+        for( const monster *mon : horde ) {
+            for( const npc *guy : npcs ) {
+                seen += mon->sees( *guy );
+            }
+        }
+        return seen;
+    };
+
+    here.clear_visibility_targets();
+    BENCHMARK( "lines of sight" ) {
+        return horde_looks_at_npcs();
+    };
+    for( const npc *guy : npcs ) {
+        here.add_visibility_target( guy->pos() );
+    }
+    here.begin_target_sight_checks();
+    BENCHMARK( "visibility fields" ) {
+        return horde_looks_at_npcs();
+    };
+    here.end_target_sight_checks();
+    here.clear_visibility_targets();
+}
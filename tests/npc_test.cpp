@@ -492,3 +492,37 @@ TEST_CASE( "npc_move_through_vehicle_holes" )
     CHECK( m2 == nullptr );
 
 }
+
+TEST_CASE( "npc_searches_are_spread_across_turns" )
+{
+    clear_all_state();
+    std::vector<npc *> npcs;
+    for( int i = 0; i < 6; i++ ) {
+        npcs.push_back( &spawn_npc( point( 50 + 2 * i, 50 ), "test_talker" ) );
+    }
+    npc_perception &perception = get_npc_perception();
+    const auto searches = [&]() {
+        std::vector<bool> result;
+        for( const npc *guy : npcs ) {
+            result.push_back( perception.may_search( *guy ) );
+        }
+        return result;
+    };
+    REQUIRE( npc_perception::searches_per_turn == 4 );
+
+    CHECK( searches() == std::vector<bool> { true, true, true, true, false, false } );
+    // Those that were turned down go first
+    calendar::turn += 1_turns;
+    CHECK( searches() == std::vector<bool> { true, true, false, false, true, true } );
+    calendar::turn += 1_turns;
+    CHECK( searches() == std::vector<bool> { true, true, true, true, false, false } );
+    CHECK( perception.searches == 12 );
+    CHECK( perception.postponed == 6 );
+
+    SECTION( "unless they no longer want to search" ) {
+        calendar::turn += 1_turns;
+        CHECK( perception.may_search( *npcs[0] ) );
+        calendar::turn += 1_turns;
+        CHECK( searches() == std::vector<bool> { true, true, true, true, false, false } );
+    }
+}
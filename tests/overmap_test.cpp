@@ -2,11 +2,16 @@
 
 #include <algorithm>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "calendar.h"
 #include "enums.h"
 #include "game_constants.h"
+#include "json.h"
+#include "mongroup.h"
+#include "monster.h"
 #include "numeric_interval.h"
 #include "omdata.h"
 #include "overmap.h"
@@ -217,3 +222,281 @@ TEST_CASE( "is_ot_match", "[overmap][terrain]" )
         CHECK_FALSE( is_ot_match( "forestry", oter_id( "forest" ), ot_match_type::contains ) );
     }
 }
+
+static int count_terrain_differences( const overmap &a, const overmap &b )
+{
+    int differences = 0;
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        for( int x = 0; x < OMAPX; ++x ) {
+            for( int y = 0; y < OMAPY; ++y ) {
+                if( a.ter( { x, y, z } ) != b.ter( { x, y, z } ) ) {
+                    differences++;
+                }
+            }
+        }
+    }
+    return differences;
+}
+
+TEST_CASE( "overmap_terrain_survives_save_and_load", "[overmap]" )
+{
+    clear_all_state();
+    std::unique_ptr<overmap> original = std::make_unique<overmap>( point_abs_om() );
+    const oter_id field( "field" );
+    const oter_id forest( "forest" );
+    // Runs of varying length, on some of the z-levels only.
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; z += 4 ) {
+        for( int x = 0; x < OMAPX; ++x ) {
+            for( int y = 0; y < OMAPY; ++y ) {
+                if( ( x + y * 3 + z ) % 7 < 3 ) {
+                    original->ter_set( { x, y, z }, x % 2 == 0 ? field : forest );
+                }
+            }
+        }
+    }
+    std::ostringstream saved;
+    original->serialize( saved );
+
+    std::unique_ptr<overmap> loaded = std::make_unique<overmap>( point_abs_om() );
+    std::istringstream saved_in( saved.str() );
+    loaded->unserialize( saved_in, "saved" );
+    CHECK( count_terrain_differences( *original, *loaded ) == 0 );
+
+    // Layers that were never accessed are written back without unpacking them.
+    std::unique_ptr<overmap> untouched = std::make_unique<overmap>( point_abs_om() );
+    std::istringstream saved_again_in( saved.str() );
+    untouched->unserialize( saved_again_in, "saved" );
+    std::ostringstream saved_again;
+    untouched->serialize( saved_again );
+    CHECK( saved_again.str() == saved.str() );
+}
+
+// Terrain of the overmap in the format used before terrain id tables were introduced.
+static std::string legacy_terrain_save( const overmap &om )
+{
+    std::ostringstream out;
+    out << "# version 28" << std::endl;
+    JsonOut json( out );
+    json.start_object();
+    json.member( "layers" );
+    json.start_array();
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        json.start_array();
+        oter_id last( -1 );
+        int count = 0;
+        for( int y = 0; y < OMAPY; ++y ) {
+            for( int x = 0; x < OMAPX; ++x ) {
+                const oter_id &t = om.ter( { x, y, z } );
+                if( t != last && count > 0 ) {
+                    json.start_array();
+                    json.write( last.id() );
+                    json.write( count );
+                    json.end_array();
+                    count = 0;
+                }
+                last = t;
+                count++;
+            }
+        }
+        json.start_array();
+        json.write( last.id() );
+        json.write( count );
+        json.end_array();
+        json.end_array();
+    }
+    json.end_array();
+    json.end_object();
+    return out.str();
+}
+
+TEST_CASE( "overmap_load_benchmark", "[.][overmap][benchmark]" )
+{
+    clear_all_state();
+    const overmap &generated = overmap_buffer.get( point_abs_om() );
+    // Only the terrain is copied, so that both formats hold the same data.
+    std::unique_ptr<overmap> terrain_only = std::make_unique<overmap>( point_abs_om( 1, 0 ) );
+    for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+        for( int x = 0; x < OMAPX; ++x ) {
+            for( int y = 0; y < OMAPY; ++y ) {
+                terrain_only->ter_set( { x, y, z }, generated.ter( { x, y, z } ) );
+            }
+        }
+    }
+    std::ostringstream saved;
+    terrain_only->serialize( saved );
+    const std::string current = saved.str();
+    const std::string legacy = legacy_terrain_save( generated );
+
+    BENCHMARK( "load, legacy terrain format" ) {
+        std::unique_ptr<overmap> om = std::make_unique<overmap>( point_abs_om( 1, 0 ) );
+        std::istringstream in( legacy );
+        om->unserialize( in, "legacy" );
+        return om->ter( { 0, 0, 0 } );
+    };
+    BENCHMARK( "load, surface only accessed" ) {
+        std::unique_ptr<overmap> om = std::make_unique<overmap>( point_abs_om( 1, 0 ) );
+        std::istringstream in( current );
+        om->unserialize( in, "current" );
+        return om->ter( { 0, 0, 0 } );
+    };
+    BENCHMARK( "load, all layers accessed" ) {
+        std::unique_ptr<overmap> om = std::make_unique<overmap>( point_abs_om( 1, 0 ) );
+        std::istringstream in( current );
+        om->unserialize( in, "current" );
+        int sum = 0;
+        for( int z = -OVERMAP_DEPTH; z <= OVERMAP_HEIGHT; ++z ) {
+            sum += om->ter( { 0, 0, z } ).to_i();
+        }
+        return sum;
+    };
+}
+
+static mongroup test_horde( const tripoint_om_sm &pos, const point_om_sm &target, int zombies )
+{
+    mongroup horde( mongroup_id( "GROUP_ZOMBIE" ), pos, 1, 0 );
+    horde.horde = true;
+    horde.horde_behaviour = "roam";
+    horde.set_target( target );
+    horde.interest = 100;
+    for( int i = 0; i < zombies; ++i ) {
+        horde.monsters.emplace_back( mtype_id( "mon_zombie" ) );
+    }
+    return horde;
+}
+
+// Monster groups on the first overmap within the given x range on a row of submaps
+static std::vector<mongroup *> groups_in_row( int min_x, int max_x, int y )
+{
+    std::vector<mongroup *> result;
+    for( int x = min_x; x <= max_x; ++x ) {
+        std::vector<mongroup *> here = overmap_buffer.groups_at( tripoint_abs_sm( x, y, 0 ) );
+        result.insert( result.end(), here.begin(), here.end() );
+    }
+    return result;
+}
+
+TEST_CASE( "hordes_move_toward_their_target_with_their_monsters", "[overmap][horde]" )
+{
+    clear_all_state();
+    overmap &om = overmap_buffer.get( point_abs_om() );
+    om.clear_mon_groups();
+    for( int x = 0; x < 40; ++x ) {
+        for( int y = 0; y < 15; ++y ) {
+            om.ter_set( tripoint_om_omt( x, y, 0 ), oter_id( "field" ) );
+        }
+    }
+    om.add_mon_group( test_horde( tripoint_om_sm( 10, 10, 0 ), point_om_sm( 60, 10 ), 3 ) );
+    om.add_mon_group( test_horde( tripoint_om_sm( 10, 20, 0 ), point_om_sm( 60, 20 ), 5 ) );
+    // Not a horde, stays where it is
+    om.add_mon_group( mongroup( mongroup_id( "GROUP_ZOMBIE" ), tripoint_om_sm( 10, 25, 0 ), 1, 4 ) );
+
+    for( int i = 0; i < 40; ++i ) {
+        om.move_hordes();
+    }
+    for( const std::pair<int, size_t> &row : {
+             std::make_pair( 10, size_t( 3 ) ), std::make_pair( 20, size_t( 5 ) )
+         } ) {
+        CAPTURE( row.first );
+        const std::vector<mongroup *> horde = groups_in_row( 0, 60, row.first );
+        REQUIRE( horde.size() == 1 );
+        CHECK( horde[0]->pos.x() > 10 );
+        CHECK( horde[0]->pos.x() <= 50 );
+        CHECK( horde[0]->pos.y() == row.first );
+        CHECK( horde[0]->monsters.size() == row.second );
+    }
+    CHECK( groups_in_row( 10, 10, 25 ).size() == 1 );
+}
+
+TEST_CASE( "signals_reach_only_hordes_in_range", "[overmap][horde]" )
+{
+    clear_all_state();
+    overmap &om = overmap_buffer.get( point_abs_om() );
+    om.clear_mon_groups();
+    const point_om_sm far_away( 150, 150 );
+    // No interest left, so they all follow a signal they hear
+    for( const tripoint_om_sm &p : {
+             tripoint_om_sm( 30, 30, 0 ), tripoint_om_sm( 39, 35, 0 ),
+             tripoint_om_sm( 30, 50, 0 ), tripoint_om_sm( 60, 35, 0 )
+         } ) {
+        mongroup horde = test_horde( p, far_away, 1 );
+        horde.interest = 0;
+        om.add_mon_group( horde );
+    }
+
+    om.signal_hordes( tripoint_rel_sm( 30, 35, 0 ), 10 );
+    CHECK( groups_in_row( 30, 30, 30 )[0]->target.xy() == point_om_sm( 30, 35 ) );
+    CHECK( groups_in_row( 39, 39, 35 )[0]->target.xy() == point_om_sm( 30, 35 ) );
+    CHECK( groups_in_row( 30, 30, 50 )[0]->target.xy() == far_away );
+    CHECK( groups_in_row( 60, 60, 35 )[0]->target.xy() == far_away );
+}
+
+TEST_CASE( "horde_movement_benchmark", "[.][overmap][benchmark]" )
+{
+    clear_all_state();
+    overmap &om = overmap_buffer.get( point_abs_om() );
+    om.clear_mon_groups();
+    // 2000 hordes of 20 zombies, wandering about the whole overmap
+    for( int i = 0; i < 2000; ++i ) {
+        const tripoint_om_sm p( 7 + i % 40 * 8, 5 + i / 40 * 7, 0 );
+        om.add_mon_group( test_horde( p, point_om_sm( ( p.x() * 7 ) % 360, ( p.y() * 3 ) % 360 ), 20 ) );
+    }
+
+    BENCHMARK( "sleeping for eight hours" ) {
+        // Hordes move every 2.5 minutes
+        for( int i = 0; i < 8 * 24; ++i ) {
+            om.move_hordes();
+        }
+    };
+    BENCHMARK( "gunshots" ) {
+        for( int i = 0; i < 100; ++i ) {
+            om.signal_hordes( tripoint_rel_sm( 3 * i, 2 * i, 0 ), 40 );
+        }
+    };
+}
+
+TEST_CASE( "npc_travel_paths_follow_terrain_changes", "[overmap][pathfinding]" )
+{
+    clear_all_state();
+    overmap_buffer.get( point_abs_om() );
+    const overmap_path_params params = overmap_path_params::for_npc();
+    const tripoint_abs_omt from( 10, 10, 0 );
+    const tripoint_abs_omt to( 150, 120, 0 );
+    overmap_buffer.ter_set( from, oter_id( "field" ) );
+    overmap_buffer.ter_set( to, oter_id( "field" ) );
+
+    const std::vector<tripoint_abs_omt> path = overmap_buffer.get_travel_path( from, to, params );
+    REQUIRE( path.size() > 1 );
+    CHECK( path.front() == to );
+    CHECK( path.back() == from );
+    CHECK( overmap_buffer.get_travel_path( from, to, params ) == path );
+
+    // Nobody travels through rock
+    const tripoint_abs_omt blocked = path[path.size() / 2];
+    overmap_buffer.ter_set( blocked, oter_id( "empty_rock" ) );
+    const std::vector<tripoint_abs_omt> detour = overmap_buffer.get_travel_path( from, to, params );
+    REQUIRE( detour.size() > 1 );
+    CHECK( std::find( detour.begin(), detour.end(), blocked ) == detour.end() );
+}
+
+TEST_CASE( "npc_travel_benchmark", "[.][overmap][benchmark]" )
+{
+    clear_all_state();
+    for( const point_abs_om &om : {
+             point_abs_om( 0, 0 ), point_abs_om( 1, 0 ), point_abs_om( 0, 1 ), point_abs_om( 1, 1 )
+         } ) {
+        overmap_buffer.get( om );
+    }
+    const overmap_path_params params = overmap_path_params::for_npc();
+    // From one corner of the four overmaps to the other
+    const tripoint_abs_omt from( 20, 20, 0 );
+    const tripoint_abs_omt to( 2 * OMAPX - 20, 2 * OMAPY - 20, 0 );
+
+    BENCHMARK( "new route" ) {
+        // As if the terrain changed, so the route is searched again
+        overmap::terrain_revision++;
+        return overmap_buffer.get_travel_path( from, to, params ).size();
+    };
+    BENCHMARK( "known route" ) {
+        return overmap_buffer.get_travel_path( from, to, params ).size();
+    };
+}
@@ -0,0 +1,267 @@
+#include "catch/catch.hpp"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "calendar.h"
+#include "game_constants.h"
+#include "line.h"
+#include "map.h"
+#include "map_helpers.h"
+#include "pathfinding.h"
+#include "point.h"
+#include "state_helpers.h"
+#include "type_id.h"
+
+static const pathfinding_settings walker( 0, 1000, 5000, 0, true, false, true, false, false );
+
+// Rows of walls across the whole map, each with a single gap at alternating ends.
+static void build_maze()
+{
+    build_test_map( ter_id( "t_floor" ) );
+    map &here = get_map();
+    const ter_id t_wall( "t_wall" );
+    for( int y = 10; y < 120; y += 10 ) {
+        const int gap = y % 20 == 0 ? 15 : 115;
+        for( int x = 0; x < MAPSIZE_X; x++ ) {
+            if( x != gap ) {
+                here.ter_set( tripoint( x, y, 0 ), t_wall );
+            }
+        }
+    }
+}
+
+static void check_route( const tripoint &from, const tripoint &to,
+                         const std::vector<tripoint> &route )
+{
+    map &here = get_map();
+    REQUIRE( !route.empty() );
+    CHECK( route.back() == to );
+    tripoint prev = from;
+    for( const tripoint &p : route ) {
+        CHECK( square_dist( prev, p ) == 1 );
+        CHECK( here.passable( p ) );
+        prev = p;
+    }
+}
+
+TEST_CASE( "route_through_maze_is_stable_across_searches", "[pathfinding]" )
+{
+    clear_all_state();
+    build_maze();
+    map &here = get_map();
+    const tripoint from( 20, 5, 0 );
+    const tripoint to( 100, 45, 0 );
+
+    const std::vector<tripoint> first = here.route( from, to, walker, {} );
+    check_route( from, to, first );
+    // Through the gaps at both ends
+    CHECK( first.size() > 400 );
+
+    // Searches reuse the same node storage, leftovers must not leak into later ones
+    here.route( tripoint( 100, 100, 0 ), tripoint( 3, 3, 0 ), walker, {} );
+    CHECK( here.route( from, to, walker, {} ) == first );
+
+    // Closed tiles are forgotten once the search that closed them is over
+    const std::set<tripoint> blocked = { tripoint( 15, 20, 0 ) };
+    CHECK( here.route( from, to, walker, blocked ).empty() );
+    CHECK( here.route( from, to, walker, {} ) == first );
+}
+
+static bool route_passes( const std::vector<tripoint> &route, const tripoint &p )
+{
+    return std::find( route.begin(), route.end(), p ) != route.end();
+}
+
+TEST_CASE( "long_routes_detour_far_from_both_ends", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( ter_id( "t_floor" ) );
+    map &here = get_map();
+    const ter_id t_wall( "t_wall" );
+    // A wall across the map with gaps near both ends, further away than a local search looks
+    const tripoint west_gap( 5, 60, 0 );
+    const tripoint east_gap( 125, 60, 0 );
+    for( int x = 0; x < MAPSIZE_X; x++ ) {
+        if( x != west_gap.x && x != east_gap.x ) {
+            here.ter_set( tripoint( x, 60, 0 ), t_wall );
+        }
+    }
+    const tripoint from( 66, 45, 0 );
+    const tripoint to( 66, 75, 0 );
+
+    const std::vector<tripoint> route = here.route( from, to, walker, {} );
+    check_route( from, to, route );
+    CHECK( route_passes( route, east_gap ) );
+
+    SECTION( "after the gap it took was closed" ) {
+        here.ter_set( east_gap, t_wall );
+        const std::vector<tripoint> detour = here.route( from, to, walker, {} );
+        check_route( from, to, detour );
+        CHECK( route_passes( detour, west_gap ) );
+    }
+    SECTION( "after both gaps were closed" ) {
+        here.ter_set( east_gap, t_wall );
+        here.ter_set( west_gap, t_wall );
+        CHECK( here.route( from, to, walker, {} ).empty() );
+    }
+    SECTION( "with someone standing in the gap" ) {
+        const std::set<tripoint> blocked = { east_gap };
+        const std::vector<tripoint> detour = here.route( from, to, walker, blocked );
+        check_route( from, to, detour );
+        CHECK( route_passes( detour, west_gap ) );
+    }
+}
+
+TEST_CASE( "followed_routes_are_repaired_locally", "[pathfinding]" )
+{
+    clear_all_state();
+    build_test_map( ter_id( "t_floor" ) );
+    map &here = get_map();
+    const tripoint from( 20, 20, 0 );
+    const tripoint to( 60, 20, 0 );
+    std::vector<tripoint> path = here.route( from, to, walker, {} );
+    route_cache cache;
+    here.remember_route( path, cache, from, walker );
+    const std::vector<tripoint> original = path;
+    route_cache_stats &stats = get_route_cache_stats();
+    stats = route_cache_stats();
+
+    CHECK( here.repair_route( path, cache, from, to, walker, {} ) );
+    CHECK( path == original );
+    CHECK( stats.hits == 1 );
+
+    SECTION( "destination moved a little" ) {
+        const tripoint moved( 61, 22, 0 );
+        CHECK( here.repair_route( path, cache, from, moved, walker, {} ) );
+        check_route( from, moved, path );
+        CHECK( stats.repairs == 1 );
+    }
+    SECTION( "wall built on the way" ) {
+        const tripoint wall = original[10];
+        here.ter_set( wall, ter_id( "t_wall" ) );
+        CHECK( here.repair_route( path, cache, from, to, walker, {} ) );
+        check_route( from, to, path );
+        CHECK( !route_passes( path, wall ) );
+        CHECK( stats.repairs == 1 );
+    }
+    SECTION( "someone standing on the next steps" ) {
+        const std::set<tripoint> blocked = { original[2] };
+        CHECK( here.repair_route( path, cache, from, to, walker, blocked ) );
+        check_route( from, to, path );
+        CHECK( !route_passes( path, original[2] ) );
+        CHECK( stats.repairs == 1 );
+    }
+    SECTION( "destination moved far away" ) {
+        CHECK( !here.repair_route( path, cache, from, tripoint( 60, 40, 0 ), walker, {} ) );
+        CHECK( stats.misses == 1 );
+    }
+}
+
+// Monsters scattered between the walls of the maze
+static std::vector<tripoint> horde_positions()
+{
+    std::vector<tripoint> horde;
+    for( int y = 3; y < 60; y += 10 ) {
+        for( int x = 10; x < 120; x += 14 ) {
+            horde.emplace_back( x, y, 0 );
+        }
+    }
+    return horde;
+}
+
+TEST_CASE( "shared_target_routes_are_deterministic", "[pathfinding]" )
+{
+    clear_all_state();
+    build_maze();
+    map &here = get_map();
+    const tripoint target( 100, 45, 0 );
+    const std::vector<tripoint> horde = horde_positions();
+
+    std::vector<std::vector<tripoint>> routes;
+    for( const tripoint &p : horde ) {
+        routes.push_back( here.route_to_shared_target( p, target, walker ) );
+        check_route( p, target, routes.back() );
+    }
+
+    SECTION( "in reverse order, from a rebuilt pathfinding cache" ) {
+        here.set_pathfinding_cache_dirty( 0 );
+        for( size_t i = horde.size(); i-- > 0; ) {
+            CHECK( here.route_to_shared_target( horde[i], target, walker ) == routes[i] );
+        }
+    }
+    SECTION( "on the next turn" ) {
+        calendar::turn += 1_turns;
+        for( size_t i = 0; i < horde.size(); i++ ) {
+            CHECK( here.route_to_shared_target( horde[i], target, walker ) == routes[i] );
+        }
+    }
+    SECTION( "after the map changed" ) {
+        // Close the gap next to the target, the others must find their way around
+        here.ter_set( tripoint( 15, 40, 0 ), ter_id( "t_wall" ) );
+        for( size_t i = 0; i < horde.size(); i++ ) {
+            CHECK( here.route_to_shared_target( horde[i], target, walker ) ==
+                   ( horde[i].y > 40 ? routes[i] : std::vector<tripoint>() ) );
+        }
+    }
+}
+
+TEST_CASE( "shared_target_routes_along_the_map_edge", "[pathfinding]" )
+{
+    clear_all_state();
+    build_maze();
+    map &here = get_map();
+    // Both the target and the routes touch the edge, the field must not look past it
+    const tripoint target( 0, 45, 0 );
+    for( const tripoint &p : {
+             tripoint( 0, 35, 0 ), tripoint( 0, 55, 0 ), tripoint( MAPSIZE_X - 1, 38, 0 )
+         } ) {
+        CAPTURE( p );
+        check_route( p, target, here.route_to_shared_target( p, target, walker ) );
+    }
+}
+
+TEST_CASE( "route_benchmark", "[.][pathfinding][benchmark]" )
+{
+    clear_all_state();
+    build_maze();
+    map &here = get_map();
+
+    BENCHMARK( "open ground" ) {
+        return here.route( tripoint( 20, 3, 0 ), tripoint( 110, 8, 0 ), walker, {} ).size();
+    };
+    BENCHMARK( "maze" ) {
+        return here.route( tripoint( 20, 5, 0 ), tripoint( 100, 45, 0 ), walker, {} ).size();
+    };
+    BENCHMARK( "unreachable" ) {
+        return here.route( tripoint( 20, 5, 0 ), tripoint( 100, 15, 0 ), walker,
+                           std::set<tripoint> { tripoint( 115, 10, 0 ) } ).size();
+    };
+}
+
+TEST_CASE( "horde_chase_benchmark", "[.][pathfinding][benchmark]" )
+{
+    clear_all_state();
+    build_maze();
+    map &here = get_map();
+    const tripoint target( 100, 45, 0 );
+    const std::vector<tripoint> horde = horde_positions();
+
+    BENCHMARK( "one search per monster" ) {
+        size_t steps = 0;
+        for( const tripoint &p : horde ) {
+            steps += here.route( p, target, walker ).size();
+        }
+        return steps;
+    };
+    BENCHMARK( "shared flow field" ) {
+        // A new turn, so the field is computed once per run
+        calendar::turn += 1_turns;
+        size_t steps = 0;
+        for( const tripoint &p : horde ) {
+            steps += here.route_to_shared_target( p, target, walker ).size();
+        }
+        return steps;
+    };
+}
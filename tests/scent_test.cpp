@@ -1,7 +1,12 @@
 
 #include "scent_map.h"
 #include "catch/catch.hpp"
+#include "calendar.h"
 #include "map.h"
+#include "rng.h"
+#include "type_id.h"
+#include "units_angle.h"
+#include "vehicle.h"
 #include "map_helpers.h"
 #include "game.h"
 #include "state_helpers.h"
@@ -170,3 +175,157 @@ TEST_CASE( "scent_matches_old", "[.]" )
     }
 }
 
+
+// scent_map::update as it was before the blur was split into separate passes
+static void reference_scent_map_update( const tripoint &center, map &m,
+                                        std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> &grscent )
+{
+    //the block and reduce scent properties are folded into a single scent_transfer value here
+    //block=0 reduce=1 normal=5
+    std::array<std::array<char, MAPSIZE_Y>, MAPSIZE_X> scent_transfer;
+
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > new_scent;
+    std::array < std::array < int, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > sum_3_scent_y;
+    std::array < std::array < char, 3 + SCENT_RADIUS * 2 >, 1 + SCENT_RADIUS * 2 > squares_used_y;
+
+    diagonal_blocks( &blocked_cache )[MAPSIZE_X][MAPSIZE_Y] = m.access_cache(
+                center.z ).vehicle_obstructed_cache;
+
+    // for loop constants
+    const int scentmap_minx = center.x - SCENT_RADIUS;
+    const int scentmap_maxx = center.x + SCENT_RADIUS;
+    const int scentmap_miny = center.y - SCENT_RADIUS;
+    const int scentmap_maxy = center.y + SCENT_RADIUS;
+
+    // The new scent flag searching function. Should be wayyy faster than the old one.
+    m.scent_blockers( scent_transfer, point( scentmap_minx - 1, scentmap_miny - 1 ),
+                      point( scentmap_maxx + 1, scentmap_maxy + 1 ) );
+
+    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
+        sum_3_scent_y[0][x] = 0;
+        squares_used_y[0][x] = 0;
+        sum_3_scent_y[SCENT_RADIUS * 2][x] = 0;
+        squares_used_y[SCENT_RADIUS * 2][x] = 0;
+    }
+
+    for( int x = 0; x < SCENT_RADIUS * 2 + 3; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+
+            point abs( x + scentmap_minx - 1, y + scentmap_miny );
+
+            // remember the sum of the scent val for the 3 neighboring squares that can defuse into
+            sum_3_scent_y[y][x] = 0;
+            squares_used_y[y][x] = 0;
+            for( int i = abs.y - 1; i <= abs.y + 1; ++i ) {
+                sum_3_scent_y[y][x] += scent_transfer[abs.x][i] * grscent[abs.x][i];
+                squares_used_y[y][x] += scent_transfer[abs.x][i];
+            }
+        }
+    }
+
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            const point abs( x + scentmap_minx - 1, y + scentmap_miny );
+
+            int squares_used = squares_used_y[y][x - 1] + squares_used_y[y][x] + squares_used_y[y][x + 1];
+            int total = sum_3_scent_y[y][x - 1] + sum_3_scent_y[y][x] + sum_3_scent_y[y][x + 1];
+
+            //handle vehicle holes
+            if( blocked_cache[abs.x][abs.y].nw && scent_transfer[abs.x + 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x][abs.y].ne && scent_transfer[abs.x - 1][abs.y + 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y + 1];
+            }
+            if( blocked_cache[abs.x - 1][abs.y - 1].nw && scent_transfer[abs.x - 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x - 1][abs.y - 1];
+            }
+            if( blocked_cache[abs.x + 1][abs.y - 1].ne && scent_transfer[abs.x + 1][abs.y - 1] == 5 ) {
+                squares_used -= 4;
+                total -= 4 * grscent[abs.x + 1][abs.y - 1];
+            }
+
+            //Lingering scent
+            int temp_scent =  grscent[abs.x][abs.y] * ( 250 - squares_used  *
+                              scent_transfer[abs.x][abs.y] ) ;
+            temp_scent -=  grscent[abs.x][abs.y] * scent_transfer[abs.x][abs.y] *
+                           ( 45 - squares_used ) / 5;
+
+            new_scent[y][x] = ( temp_scent + total * scent_transfer[abs.x][abs.y] ) / 250;
+
+        }
+    }
+    for( int x = 1; x < SCENT_RADIUS * 2 + 2; ++x ) {
+        for( int y = 0; y < SCENT_RADIUS * 2 + 1; ++y ) {
+            grscent[x + scentmap_minx - 1 ][y + scentmap_miny] = new_scent[y][x];
+        }
+    }
+}
+
+static void build_scent_test_map( const tripoint &origin )
+{
+    map &here = get_map();
+    for( int i = -10; i <= 10; ++i ) {
+        here.ter_set( origin + tripoint( i, -5, 0 ), t_brick_wall );
+        here.ter_set( origin + tripoint( -5, i, 0 ), t_rock_wall_half );
+    }
+    here.ter_set( origin + tripoint( 0, -5, 0 ), t_door_o );
+    // Rotated, so that its walls have diagonal holes
+    here.add_vehicle( vproto_id( "apc" ), origin + tripoint( 12, 12, 0 ), -45_degrees, 0, 0 );
+    here.build_map_cache( 0 );
+}
+
+TEST_CASE( "scent_update_matches_reference", "[scent]" )
+{
+    clear_all_state();
+    const tripoint origin( 60, 60, 0 );
+    g->place_player( origin );
+    map &here = get_map();
+    build_scent_test_map( origin );
+
+    std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> reference;
+    g->scent.reset();
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            reference[x][y] = one_in( 4 ) ? rng( 0, 10000 ) : 0;
+            g->scent.set( { x, y, 0 }, reference[x][y] );
+        }
+    }
+
+    for( int turn = 0; turn < 5; ++turn ) {
+        g->scent.update( origin, here );
+        reference_scent_map_update( origin, here, reference );
+    }
+    for( int x = 0; x < MAPSIZE_X; ++x ) {
+        for( int y = 0; y < MAPSIZE_Y; ++y ) {
+            INFO( x );
+            INFO( y );
+            CHECK( reference[x][y] == g->scent.get( { x, y, 0 } ) );
+        }
+    }
+}
+
+TEST_CASE( "scent_update_benchmark", "[.][scent][benchmark]" )
+{
+    clear_all_state();
+    const tripoint origin( 60, 60, 0 );
+    g->place_player( origin );
+    map &here = get_map();
+    build_scent_test_map( origin );
+    g->scent.reset();
+    g->scent.set( origin, 10000, scenttype_id( "sc_human" ) );
+
+    std::array<std::array<int, MAPSIZE_Y>, MAPSIZE_X> reference = {};
+    reference[origin.x][origin.y] = 10000;
+    BENCHMARK( "reference" ) {
+        reference_scent_map_update( origin, here, reference );
+        return reference[origin.x][origin.y];
+    };
+    BENCHMARK( "scent_map::update" ) {
+        g->scent.update( origin, here );
+        return g->scent.get( origin );
+    };
+}
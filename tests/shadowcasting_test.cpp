@@ -6,6 +6,7 @@
 #include <functional>
 #include <memory>
 #include <random>
+#include <string>
 #include <vector>
 
 #include "game_constants.h"
@@ -670,3 +671,34 @@ TEST_CASE( "bresenham_vs_shadowcasting", "[.]" )
     clear_all_state();
     shadowcasting_runoff( 1, true );
 }
+
+TEST_CASE( "shadowcasting_benchmark", "[.][shadowcasting][benchmark]" )
+{
+    clear_all_state();
+    static float seen_squares[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
+    static four_quadrants lit_squares[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{}};
+    static float transparency_cache[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{0}};
+    static diagonal_blocks blocked_cache[MAPSIZE * SEEX][MAPSIZE * SEEY] = {{{false, false}}};
+    randomly_fill_transparency( transparency_cache );
+    const point offset( 65, 65 );
+
+    const bool old_trigdist = trigdist;
+    for( const bool use_trigdist : {
+             false, true
+         } ) {
+        trigdist = use_trigdist;
+        const std::string suffix = use_trigdist ? ", trigdist" : "";
+        BENCHMARK( "float" + suffix ) {
+            castLightAll<float, float, sight_calc, sight_check, update_light, accumulate_transparency>(
+                seen_squares, transparency_cache, blocked_cache, offset );
+            return seen_squares[0][0];
+        };
+        BENCHMARK( "four_quadrants" + suffix ) {
+            castLightAll<float, four_quadrants, sight_calc, sight_check, update_light_quadrants,
+                         accumulate_transparency>(
+                             lit_squares, transparency_cache, blocked_cache, offset );
+            return lit_squares[0][0].max();
+        };
+    }
+    trigdist = old_trigdist;
+}
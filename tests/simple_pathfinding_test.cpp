@@ -1,5 +1,8 @@
 #include "catch/catch.hpp"
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "simple_pathfinding.h"
 
 #include "coordinates.h"
@@ -141,3 +144,43 @@ TEST_CASE( "find_overmap_path_bridge", "[pathfinding]" )
     CHECK( pth.points[0] == Point( 2, 0, 0 ) );
 }
 
+
+// A field with a wall across it and a single gap in the wall
+static pf::omt_score walled_field( const tripoint_abs_omt &p )
+{
+    if( std::abs( p.x() ) > 40 || std::abs( p.y() ) > 40 || p.z() != 0 ) {
+        return pf::omt_score::rejected;
+    }
+    if( p.x() == 5 && p.y() != -30 ) {
+        return pf::omt_score::rejected;
+    }
+    return pf::omt_score( 10 );
+}
+
+TEST_CASE( "find_overmap_path_reuses_search_state", "[pathfinding]" )
+{
+    clear_all_state();
+    using Point = tripoint_abs_omt;
+    const Point start( -20, 10, 0 );
+    const Point finish( 30, 10, 0 );
+    const Point gap( 5, -30, 0 );
+    const auto scorer = []( const Point & p ) {
+        return walled_field( p );
+    };
+
+    const pf::simple_path<Point> first = pf::find_overmap_path( start, finish, 100, scorer );
+    REQUIRE( first.points.size() > 1 );
+    CHECK( first.points.front() == finish );
+    CHECK( first.points.back() == start );
+    CHECK( std::find( first.points.begin(), first.points.end(), gap ) != first.points.end() );
+    for( size_t i = 1; i < first.points.size(); ++i ) {
+        CHECK( manhattan_dist( first.points[i - 1].xy(), first.points[i].xy() ) == 1 );
+    }
+
+    // Nodes left over from another search must not leak into the next one
+    CHECK( !pf::find_overmap_path( finish, Point( 35, -35, 0 ), 100, scorer ).points.empty() );
+    CHECK( pf::find_overmap_path( start, finish, 100, scorer ).points == first.points );
+
+    const pf::omt_scoring_fn scoring_fn = scorer;
+    CHECK( pf::find_overmap_path( start, finish, 100, scoring_fn ).points == first.points );
+}
@@ -8,6 +8,7 @@
 #include "game.h"
 #include "map.h"
 #include "name.h"
+#include "npc.h"
 
 void clear_all_state( )
 {
@@ -16,5 +17,6 @@ void clear_all_state( )
     clear_map();
     clear_avatar();
     set_time( calendar::turn_zero );
+    get_npc_perception() = npc_perception();
     Name::clear();
 }
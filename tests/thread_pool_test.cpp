@@ -0,0 +1,52 @@
+#include "catch/catch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "cached_options.h"
+#include "thread_pool.h"
+
+TEST_CASE( "thread_pool_runs_every_task_once", "[thread_pool]" )
+{
+    const int old_worker_threads = worker_threads;
+    for( int threads : {
+             1, 2, 4
+         } ) {
+        worker_threads = threads;
+        CAPTURE( threads );
+        CHECK( thread_pool::concurrency() == threads );
+        for( size_t count : {
+                 0, 1, 3, 100
+             } ) {
+            CAPTURE( count );
+            std::vector<int> calls( count );
+            std::atomic<int> nested_calls( 0 );
+            thread_pool::run( count, [&]( size_t i ) {
+                calls[i]++;
+                thread_pool::run( 2, [&]( size_t ) {
+                    nested_calls++;
+                } );
+            } );
+            CHECK( calls == std::vector<int>( count, 1 ) );
+            CHECK( nested_calls == static_cast<int>( count * 2 ) );
+        }
+    }
+    worker_threads = old_worker_threads;
+}
+
+TEST_CASE( "thread_pool_rethrows_task_exceptions", "[thread_pool]" )
+{
+    const int old_worker_threads = worker_threads;
+    worker_threads = 4;
+    std::atomic<int> calls( 0 );
+    CHECK_THROWS_AS( thread_pool::run( 10, [&]( size_t i ) {
+        calls++;
+        if( i == 5 ) {
+            throw std::runtime_error( "task failed" );
+        }
+    } ), std::runtime_error );
+    CHECK( calls == 10 );
+    worker_threads = old_worker_threads;
+}